@@ -28,7 +28,7 @@ CalRSSI::CalRSSI() :
 
 /* Sample RSSI values from the air interface. */
 
-void CalRSSI::samples(const uint16_t* rssi, uint8_t length)
+void CalRSSI::samples(const uint16_t* rssi, uint16_t length)
 {
     for (uint16_t i = 0U; i < length; i++) {
         uint16_t ss = rssi[i];
@@ -38,7 +38,7 @@ public:
      * @param rssi 
      * @param length 
      */
-    void samples(const uint16_t* rssi, uint8_t length);
+    void samples(const uint16_t* rssi, uint16_t length);
 
 private:
     uint32_t m_count;
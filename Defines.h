@@ -133,6 +133,30 @@ typedef unsigned long long  ulong64_t;
 // Pass RSSI information to the host
 // #define SEND_RSSI_DATA
 
+// Number of samples processed per Rx block (must be a multiple of 2).
+// Larger blocks reduce the per-call overhead of the Rx filters at the cost of Rx latency. The native SDR
+// build uses this as the default and may select a different size at runtime (up to RX_BLOCK_SIZE_MAX).
+#ifndef RX_BLOCK_SIZE
+#define RX_BLOCK_SIZE 2U
+#endif
+
+#if (RX_BLOCK_SIZE % 2 != 0)
+#error "Invalid RX_BLOCK_SIZE specified! Must be a multiple of 2"
+#endif
+
+#if defined(NATIVE_SDR)
+#define RX_BLOCK_SIZE_MAX 480U
+#else
+#define RX_BLOCK_SIZE_MAX RX_BLOCK_SIZE
+#endif
+
+#if defined(NATIVE_SDR)
+// Time (in ms) each Tx frame is handed to the SDR ahead of its on-air time; this is the amount of
+// host scheduling jitter the Tx path can absorb before the SDR runs dry.
+#define TX_LEAD_DEFAULT 60U
+#define TX_LEAD_MAX 500U
+#endif
+
 #define DESCR_DMR        "DMR, "
 #define DESCR_P25        "P25, "
 #define DESCR_NXDN       "NXDN, "
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+#include "FIRFilter.h"
+
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/* Helper to compute the 32-bit accumulating dot product of the history window and coefficients. */
+
+static inline q31_t dotProduct(const q15_t* x, const q15_t* c, uint16_t n)
+{
+#if defined(NATIVE_SDR)
+    return ::arm_dot_prod_fast_q15(x, c, n);
+#elif defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7)
+    // the history window is not necessarily word aligned, the Cortex-M4/M7 handle unaligned word loads
+    uint32_t acc = 0U;
+    uint16_t i = 0U;
+    for (; i + 2U <= n; i += 2U) {
+        uint32_t x0, c0;
+        ::memcpy(&x0, x + i, sizeof(uint32_t));
+        ::memcpy(&c0, c + i, sizeof(uint32_t));
+        acc = __SMLAD(x0, c0, acc);
+    }
+
+    if (i < n)
+        acc += (uint32_t)((q31_t)x[i] * c[i]);
+
+    return (q31_t)acc;
+#else
+    uint32_t acc = 0U;
+    for (uint16_t i = 0U; i < n; i++)
+        acc += (uint32_t)((q31_t)x[i] * c[i]);
+
+    return (q31_t)acc;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the FIRFilter class. */
+
+FIRFilter::FIRFilter() :
+    m_coeffs(nullptr),
+    m_numTaps(0U),
+    m_state(nullptr),
+    m_index(0U)
+{
+    /* stub */
+}
+
+/* Initializes the filter. */
+
+void FIRFilter::init(const q15_t* coeffs, uint16_t numTaps, q15_t* state)
+{
+    m_coeffs = coeffs;
+    m_numTaps = numTaps;
+    m_state = state;
+
+    reset();
+}
+
+/* Helper to clear the sample history. */
+
+void FIRFilter::reset()
+{
+    ::memset(m_state, 0x00U, 2U * m_numTaps * sizeof(q15_t));
+    m_index = 0U;
+}
+
+/* Filters a block of samples. */
+
+void FIRFilter::process(const q15_t* in, q15_t* out, uint16_t length)
+{
+    for (uint16_t i = 0U; i < length; i++) {
+        q15_t sample = in[i];
+
+        // write the sample to both halves; the window then starts just after it
+        m_state[m_index] = sample;
+        m_state[m_index + m_numTaps] = sample;
+
+        m_index++;
+        if (m_index >= m_numTaps)
+            m_index = 0U;
+
+        q31_t acc = dotProduct(m_state + m_index, m_coeffs, m_numTaps);
+        out[i] = (q15_t)__SSAT((acc >> 15), 16);
+    }
+}
+
+/* Initializes a new instance of the FIRFilterBank class. */
+
+FIRFilterBank::FIRFilterBank() :
+    m_coeffs(),
+    m_coeffsLen(0U),
+    m_filterStart(),
+    m_filterTaps(),
+    m_numFilters(0U),
+    m_state(),
+    m_window(0U),
+    m_length(0U),
+    m_index(0U)
+{
+    /* stub */
+}
+
+/* Adds a filter to the bank. */
+
+bool FIRFilterBank::addFilter(const q15_t* coeffs, uint16_t numTaps)
+{
+    uint16_t taps = (numTaps + FIR_BANK_ALIGN - 1U) & ~(FIR_BANK_ALIGN - 1U);
+    if (m_numFilters >= FIR_BANK_FILTERS_MAX || taps > FIR_BANK_TAPS_MAX || m_coeffsLen + taps > FIR_BANK_COEFFS_MAX)
+        return false;
+
+    // the padding multiplies the oldest samples of the window by zero, so the output is unchanged
+    q15_t* c = m_coeffs + m_coeffsLen;
+    ::memset(c, 0x00U, (taps - numTaps) * sizeof(q15_t));
+    ::memcpy(c + (taps - numTaps), coeffs, numTaps * sizeof(q15_t));
+
+    m_filterStart[m_numFilters] = m_coeffsLen;
+    m_filterTaps[m_numFilters] = taps;
+    m_numFilters++;
+    m_coeffsLen += taps;
+
+    if (taps > m_window) {
+        m_window = taps;
+        m_length = taps + FIR_BANK_BATCH;
+    }
+
+    reset();
+    return true;
+}
+
+/* Helper to clear the sample history. */
+
+void FIRFilterBank::reset()
+{
+    ::memset(m_state, 0x00U, sizeof(m_state));
+    m_index = 0U;
+}
+
+/* Filters a block of samples through each filter of the bank. */
+
+void FIRFilterBank::process(const q15_t* in, q15_t* const* out, uint16_t length)
+{
+    if (m_window == 0U)
+        return;
+
+    // gather the filters that need an output; each one covers the newest taps of the window
+    const q15_t* coeffs[FIR_BANK_FILTERS_MAX];
+    uint32_t offsets[FIR_BANK_FILTERS_MAX];
+    q15_t* outputs[FIR_BANK_FILTERS_MAX];
+    uint8_t count = 0U;
+    for (uint8_t j = 0U; j < m_numFilters; j++) {
+        if (out[j] == NULL)
+            continue;
+
+        coeffs[count] = m_coeffs + m_filterStart[j];
+        offsets[count] = m_window - m_filterTaps[j];
+        outputs[count] = out[j];
+        count++;
+    }
+
+    q31_t acc[FIR_BANK_FILTERS_MAX * FIR_BANK_BATCH];
+    uint16_t i = 0U;
+    while (i < length) {
+        // a batch never wraps the history, so the windows of all of its outputs are contiguous
+        uint16_t batch = length - i;
+        if (batch > FIR_BANK_BATCH)
+            batch = FIR_BANK_BATCH;
+        if (batch > m_length - m_index)
+            batch = m_length - m_index;
+
+        // write each sample to both halves; the window of the first output then ends at its sample
+        for (uint16_t b = 0U; b < batch; b++) {
+            q15_t sample = in[i + b];
+            m_state[m_index + b] = sample;
+            m_state[m_index + b + m_length] = sample;
+        }
+
+        const q15_t* x = m_state + m_index + 1U + m_length - m_window;
+
+        m_index += batch;
+        if (m_index >= m_length)
+            m_index = 0U;
+
+        if (count > 0U) {
+#if defined(NATIVE_SDR)
+            ::arm_fir_bank_fast_q15(x, m_window, coeffs, offsets, count, batch, acc);
+#else
+            for (uint8_t j = 0U; j < count; j++) {
+                for (uint16_t b = 0U; b < batch; b++)
+                    acc[j * batch + b] = dotProduct(x + b + offsets[j], coeffs[j], m_window - offsets[j]);
+            }
+#endif
+            for (uint8_t j = 0U; j < count; j++) {
+                for (uint16_t b = 0U; b < batch; b++)
+                    outputs[j][i + b] = (q15_t)__SSAT((acc[j * batch + b] >> 15), 16);
+            }
+        }
+
+        i += batch;
+    }
+}
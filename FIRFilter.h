@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file FIRFilter.h
+ * @ingroup modem_fw
+ * @file FIRFilter.cpp
+ * @ingroup modem_fw
+ */
+#if !defined(__FIR_FILTER_H__)
+#define __FIR_FILTER_H__
+
+#include "Defines.h"
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint8_t FIR_BANK_FILTERS_MAX = 3U;
+const uint16_t FIR_BANK_ALIGN = 8U;                     // coefficients are padded to a multiple of this
+const uint16_t FIR_BANK_TAPS_MAX = 88U;                 // longest (padded) filter
+const uint16_t FIR_BANK_COEFFS_MAX = 160U;              // all (padded) filters
+const uint16_t FIR_BANK_BATCH = 4U;                     // outputs computed together
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a Q15 FIR filter, whose sample history is kept in a double-length circular
+ *  buffer. Each sample is written twice (numTaps apart), so the last numTaps samples are always
+ *  contiguous and no history has to be moved between calls.
+ *
+ *  The output is bit-exact with arm_fir_fast_q15() (for an even number of taps).
+ * @ingroup modem_fw
+ */
+class DSP_FW_API FIRFilter {
+public:
+    /**
+     * @brief Initializes a new instance of the FIRFilter class.
+     */
+    FIRFilter();
+
+    /**
+     * @brief Initializes the filter.
+     * @param coeffs Filter coefficients (time reversed, as for arm_fir_fast_q15()).
+     * @param numTaps Number of filter coefficients.
+     * @param state Sample history buffer, 2 * numTaps samples long.
+     */
+    void init(const q15_t* coeffs, uint16_t numTaps, q15_t* state);
+    /**
+     * @brief Helper to clear the sample history.
+     */
+    void reset();
+
+    /**
+     * @brief Filters a block of samples.
+     * @param in Input samples.
+     * @param out Output samples (may be the same buffer as the input).
+     * @param length Number of samples to filter.
+     */
+    void process(const q15_t* in, q15_t* out, uint16_t length);
+
+private:
+    const q15_t* m_coeffs;
+    uint16_t m_numTaps;
+
+    q15_t* m_state;
+    uint16_t m_index;
+};
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a bank of Q15 FIR filters over the same input samples, sharing one double-length
+ *  circular sample history (see FIRFilter). Each input sample is stored once for all of the filters, and
+ *  the history is FIR_BANK_BATCH samples longer than the longest filter, so up to FIR_BANK_BATCH samples
+ *  can be stored before their outputs are computed together (in one call, on the SDR build).
+ *
+ *  Each filter's coefficients are zero padded (at the oldest end) to a multiple of FIR_BANK_ALIGN taps,
+ *  the output of each filter is bit-exact with a FIRFilter using the same coefficients.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API FIRFilterBank {
+public:
+    /**
+     * @brief Initializes a new instance of the FIRFilterBank class.
+     */
+    FIRFilterBank();
+
+    /**
+     * @brief Adds a filter to the bank. Filters are numbered in the order they are added.
+     * @param coeffs Filter coefficients (time reversed, as for arm_fir_fast_q15()).
+     * @param numTaps Number of filter coefficients.
+     * @returns bool True, if the filter was added, otherwise false.
+     */
+    bool addFilter(const q15_t* coeffs, uint16_t numTaps);
+    /**
+     * @brief Helper to clear the sample history.
+     */
+    void reset();
+
+    /**
+     * @brief Filters a block of samples through each filter of the bank.
+     *  The sample history is always updated, even if no filter outputs are required.
+     * @param in Input samples.
+     * @param out Output samples for each filter, a NULL entry skips the filter.
+     * @param length Number of samples to filter.
+     */
+    void process(const q15_t* in, q15_t* const* out, uint16_t length);
+
+private:
+    q15_t m_coeffs[FIR_BANK_COEFFS_MAX];
+    uint16_t m_coeffsLen;
+
+    uint16_t m_filterStart[FIR_BANK_FILTERS_MAX];
+    uint16_t m_filterTaps[FIR_BANK_FILTERS_MAX];
+    uint8_t m_numFilters;
+
+    q15_t m_state[2U * (FIR_BANK_TAPS_MAX + FIR_BANK_BATCH)];
+    uint16_t m_window;
+    uint16_t m_length;
+    uint16_t m_index;
+};
+
+#endif // __FIR_FILTER_H__
@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+#include "FSKModulator.h"
+
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// negating a symbol flips the high bit of its dibit (11 = +3, 10 = +1, 00 = -1, 01 = -3)
+const uint8_t FSK_MOD_GROUP_MASK = 0x3FU;
+const uint8_t FSK_MOD_NEGATE_MASK = 0x2AU;
+const uint8_t FSK_MOD_NEGATE_BIT = 5U;
+
+// each byte of a cache context is 9 bits, silent symbol periods are marked by the top bit
+const uint8_t FSK_CACHE_BYTE_BITS = 9U;
+const uint16_t FSK_CACHE_SILENT = 0x100U;
+const uint64_t FSK_CACHE_INVALID = ~0ULL;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the FSKModulator class. */
+
+FSKModulator::FSKModulator() :
+    m_coeffs(nullptr),
+    m_phaseLength(0U),
+    m_L(0U),
+    m_groups(0U),
+    m_table(nullptr),
+    m_levels(),
+    m_symbols(0U),
+    m_silence(0U)
+{
+    /* stub */
+}
+
+/* Initializes the modulator. */
+
+void FSKModulator::init(const q15_t* coeffs, uint16_t phaseLength, uint8_t L, q31_t* table)
+{
+    m_coeffs = coeffs;
+    m_phaseLength = phaseLength;
+    m_L = L;
+    m_groups = (phaseLength + FSK_MOD_GROUP_SYMBOLS - 1U) / FSK_MOD_GROUP_SYMBOLS;
+    m_table = table;
+
+    setLevels(0, 0);
+    reset();
+}
+
+/* Sets the symbol levels, rebuilding the partial sum tables. */
+
+void FSKModulator::setLevels(q15_t level3, q15_t level1)
+{
+    m_levels[0U] = -level1;
+    m_levels[1U] = -level3;
+    m_levels[2U] = level1;
+    m_levels[3U] = level3;
+
+    for (uint8_t p = 0U; p < m_L; p++) {
+        for (uint8_t g = 0U; g < m_groups; g++) {
+            q31_t* table = m_table + (p * m_groups + g) * FSK_MOD_TABLE_LEN;
+            for (uint8_t idx = 0U; idx < FSK_MOD_TABLE_LEN; idx++) {
+                q31_t sum = 0;
+                for (uint8_t j = 0U; j < FSK_MOD_GROUP_SYMBOLS; j++) {
+                    // the newest symbol (age 0) is the last of the interpolator state
+                    uint16_t age = g * FSK_MOD_GROUP_SYMBOLS + j;
+                    if (age >= m_phaseLength)
+                        break;
+
+                    q15_t coeff = m_coeffs[p + (m_phaseLength - 1U - age) * m_L];
+                    sum += (q31_t)m_levels[(idx >> (2U * j)) & 0x03U] * coeff;
+                }
+
+                table[idx] = sum;
+            }
+        }
+    }
+}
+
+/* Helper to clear the symbol history (to silence). */
+
+void FSKModulator::reset()
+{
+    m_symbols = 0U;
+    m_silence = 0xFFFFU;
+}
+
+/* Modulates the four symbols of a byte (most significant dibit first). */
+
+void FSKModulator::modulate(uint8_t c, q15_t* out)
+{
+    for (uint8_t i = 0U; i < 4U; i++, c <<= 2, out += m_L)
+        write((c >> 6) & 0x03U, false, out);
+}
+
+/* Modulates four symbol periods of silence. */
+
+void FSKModulator::silence(q15_t* out)
+{
+    for (uint8_t i = 0U; i < 4U; i++, out += m_L)
+        write(0U, true, out);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/* Helper to shift a symbol (or silence) into the history and compute its output samples. */
+
+void FSKModulator::write(uint8_t symbol, bool silent, q15_t* out)
+{
+    m_symbols = (m_symbols << 2) | symbol;
+    m_silence = (m_silence << 1) | (silent ? 1U : 0U);
+
+    // the interpolator state holds zeros for silent symbol periods, which no table covers
+    if ((m_silence & ((1U << m_phaseLength) - 1U)) != 0U) {
+        for (uint8_t k = 0U; k < m_L; k++) {
+            uint8_t p = m_L - 1U - k;
+
+            q31_t sum = 0;
+            for (uint16_t age = 0U; age < m_phaseLength; age++) {
+                if ((m_silence & (1U << age)) != 0U)
+                    continue;
+
+                q15_t coeff = m_coeffs[p + (m_phaseLength - 1U - age) * m_L];
+                sum += (q31_t)m_levels[(m_symbols >> (2U * age)) & 0x03U] * coeff;
+            }
+
+            out[k] = (q15_t)__SSAT((sum >> 15), 16);
+        }
+
+        return;
+    }
+
+    // fold each group onto the stored half of its table, remembering to negate its partial sum
+    uint8_t index[FSK_MOD_GROUPS_MAX];
+    q31_t negate[FSK_MOD_GROUPS_MAX];
+    for (uint8_t g = 0U; g < m_groups; g++) {
+        uint8_t idx = (m_symbols >> (2U * FSK_MOD_GROUP_SYMBOLS * g)) & FSK_MOD_GROUP_MASK;
+        negate[g] = -(q31_t)(idx >> FSK_MOD_NEGATE_BIT);
+        index[g] = (idx ^ (FSK_MOD_NEGATE_MASK & (uint8_t)negate[g])) & (FSK_MOD_TABLE_LEN - 1U);
+    }
+
+    for (uint8_t k = 0U; k < m_L; k++) {
+        const q31_t* table = m_table + (m_L - 1U - k) * m_groups * FSK_MOD_TABLE_LEN;
+
+        q31_t sum = 0;
+        for (uint8_t g = 0U; g < m_groups; g++, table += FSK_MOD_TABLE_LEN)
+            sum += (table[index[g]] ^ negate[g]) - negate[g];
+
+        out[k] = (q15_t)__SSAT((sum >> 15), 16);
+    }
+}
+
+/* Helper to shift the four symbols of a byte (or four silent symbol periods) into the history. */
+
+void FSKModulator::shift(uint8_t c, bool silent)
+{
+    m_symbols = (m_symbols << 8) | (silent ? 0U : c);
+    m_silence = (m_silence << 4) | (silent ? 0x0FU : 0x00U);
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the FSKWaveCache class. */
+
+FSKWaveCache::FSKWaveCache() :
+    m_modulator(nullptr),
+    m_filterState(nullptr),
+    m_filterHistory(0U),
+    m_length(0U),
+    m_historyLength(0U),
+    m_entries(0U),
+    m_keys(nullptr),
+    m_samples(nullptr),
+    m_history(nullptr),
+    m_context(0U),
+    m_contextMask(0U),
+    m_contextLength(0U),
+    m_warmup(0U),
+    m_entry(0U)
+{
+    /* stub */
+}
+
+/* Initializes the cache. */
+
+void FSKWaveCache::init(FSKModulator* modulator, q15_t* filterState, uint16_t filterTaps, uint16_t entries, uint64_t* keys,
+    q15_t* samples, q15_t* history)
+{
+    m_modulator = modulator;
+    m_filterState = filterState;
+    m_filterHistory = (filterState != NULL && filterTaps > 0U) ? filterTaps - 1U : 0U;
+
+    m_length = 4U * modulator->m_L;
+    m_historyLength = (m_filterHistory < m_length) ? m_filterHistory : m_length;
+
+    m_entries = entries;
+    m_keys = keys;
+    m_samples = samples;
+    m_history = history;
+
+    // the first sample of a byte depends on the filter inputs of the symbols its history spans, and each
+    // of those on the phaseLength - 1 symbols before it
+    uint16_t symbols = (modulator->m_phaseLength - 1U) + (m_filterHistory + modulator->m_L - 1U) / modulator->m_L;
+    m_contextLength = 1U + (symbols + 3U) / 4U;
+    if (m_contextLength > FSK_CACHE_CONTEXT_MAX)
+        m_contextLength = FSK_CACHE_CONTEXT_MAX;
+    m_contextMask = (1ULL << (FSK_CACHE_BYTE_BITS * m_contextLength)) - 1U;
+
+    // the modulator and filter histories start out silent
+    m_context = 0U;
+    for (uint8_t i = 0U; i < m_contextLength; i++)
+        m_context = (m_context << FSK_CACHE_BYTE_BITS) | FSK_CACHE_SILENT;
+
+    clear();
+}
+
+/* Helper to invalidate all of the cache entries. */
+
+void FSKWaveCache::clear()
+{
+    for (uint16_t i = 0U; i < m_entries; i++)
+        m_keys[i] = FSK_CACHE_INVALID;
+
+    // the filter history still holds samples of the old symbol levels, so nothing is stored until the
+    // context has been modulated at the new ones
+    m_warmup = m_contextLength;
+}
+
+/* Finds the cached samples of a byte (or four silent symbol periods). */
+
+const q15_t* FSKWaveCache::find(uint8_t c, bool silent)
+{
+    skip(c, silent);
+
+    uint32_t hash = (uint32_t)m_context ^ (uint32_t)(m_context >> 32);
+    hash *= 0x9E3779B1U;
+    m_entry = (hash ^ (hash >> 16)) & (m_entries - 1U);
+    if (m_keys[m_entry] != m_context)
+        return NULL;
+
+    m_modulator->shift(c, silent);
+
+    // as arm_fir_fast_q15() would leave it, the state starts with the last numTaps - 1 filter inputs
+    if (m_filterHistory > 0U) {
+        const q15_t* history = m_history + m_entry * m_length;
+        if (m_length < m_filterHistory)
+            ::memmove(m_filterState, m_filterState + m_length, (m_filterHistory - m_length) * sizeof(q15_t));
+        ::memcpy(m_filterState + m_filterHistory - m_historyLength, history, m_historyLength * sizeof(q15_t));
+    }
+
+    return m_samples + m_entry * m_length;
+}
+
+/* Stores the samples of the byte last missed by find(). */
+
+void FSKWaveCache::store(const q15_t* samples, const q15_t* filterInput)
+{
+    if (m_warmup > 0U)
+        return;
+
+    m_keys[m_entry] = m_context;
+    ::memcpy(m_samples + m_entry * m_length, samples, m_length * sizeof(q15_t));
+    if (m_filterHistory > 0U)
+        ::memcpy(m_history + m_entry * m_length, filterInput + m_length - m_historyLength, m_historyLength * sizeof(q15_t));
+}
+
+/* Shifts a byte (or four silent symbol periods) the caller modulates into the context. */
+
+void FSKWaveCache::skip(uint8_t c, bool silent)
+{
+    m_context = ((m_context << FSK_CACHE_BYTE_BITS) | (silent ? FSK_CACHE_SILENT : c)) & m_contextMask;
+
+    if (m_warmup > 0U)
+        m_warmup--;
+}
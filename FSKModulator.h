@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file FSKModulator.h
+ * @ingroup modem_fw
+ * @file FSKModulator.cpp
+ * @ingroup modem_fw
+ */
+#if !defined(__FSK_MODULATOR_H__)
+#define __FSK_MODULATOR_H__
+
+#include "Defines.h"
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint8_t FSK_MOD_PHASE_LEN_MAX = 9U;
+const uint8_t FSK_MOD_GROUP_SYMBOLS = 3U;               // symbols summed by each table
+const uint8_t FSK_MOD_GROUPS_MAX = (FSK_MOD_PHASE_LEN_MAX + FSK_MOD_GROUP_SYMBOLS - 1U) / FSK_MOD_GROUP_SYMBOLS;
+const uint8_t FSK_MOD_TABLE_LEN = 32U;                  // 4^3 symbol patterns, less the negated ones
+
+const uint8_t FSK_CACHE_CONTEXT_MAX = 7U;               // bytes of context a cache key holds
+#if defined(NATIVE_SDR)
+const uint16_t FSK_CACHE_ENTRIES = 1024U;               // enough for the calibration frame sequences
+const bool FSK_CACHE_FRAMES = true;                     // idle, CACH, PR FILL and calibration frames are cached
+#else
+const uint16_t FSK_CACHE_ENTRIES = 16U;                 // enough for the silence and preamble patterns
+const bool FSK_CACHE_FRAMES = false;                    // only silence, preambles and single tone patterns fit
+#endif
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a 4FSK modulator (symbol level mapping and pulse shaping interpolation filter).
+ *  Each output sample is the sum of the last phaseLength symbols weighted by the filter coefficients of
+ *  its phase, so the weighted sums of every pattern of FSK_MOD_GROUP_SYMBOLS symbols are tabled per phase
+ *  and an output sample is a few table lookups. Negating the symbols of a pattern negates its sum, so only
+ *  half of the patterns are stored.
+ *
+ *  The output is bit-exact with mapping the symbols to their levels and arm_fir_interpolate_q15(), as long
+ *  as the levels are unchanged. The history holds symbols rather than levels, so after setLevels() the
+ *  symbols already in it are also weighted with the new levels; the next phaseLength - 1 symbols may differ.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API FSKModulator {
+public:
+    /**
+     * @brief Initializes a new instance of the FSKModulator class.
+     */
+    FSKModulator();
+
+    /**
+     * @brief Initializes the modulator.
+     * @param coeffs Filter coefficients (as for arm_fir_interpolate_q15()).
+     * @param phaseLength Number of filter coefficients per phase (no more than FSK_MOD_PHASE_LEN_MAX).
+     * @param L Interpolation factor (number of samples per symbol).
+     * @param table Partial sum tables, L * FSK_MOD_GROUPS_MAX * FSK_MOD_TABLE_LEN entries long.
+     */
+    void init(const q15_t* coeffs, uint16_t phaseLength, uint8_t L, q31_t* table);
+    /**
+     * @brief Sets the symbol levels, rebuilding the partial sum tables. The -3 and -1 symbol levels
+     *  are the negated +3 and +1 symbol levels.
+     * @param level3 +3 symbol level.
+     * @param level1 +1 symbol level.
+     */
+    void setLevels(q15_t level3, q15_t level1);
+    /**
+     * @brief Helper to clear the symbol history (to silence).
+     */
+    void reset();
+
+    /**
+     * @brief Modulates the four symbols of a byte (most significant dibit first).
+     * @param c Byte to modulate.
+     * @param out Output samples, 4 * L samples long.
+     */
+    void modulate(uint8_t c, q15_t* out);
+    /**
+     * @brief Modulates four symbol periods of silence.
+     * @param out Output samples, 4 * L samples long.
+     */
+    void silence(q15_t* out);
+
+private:
+    const q15_t* m_coeffs;
+    uint16_t m_phaseLength;
+    uint8_t m_L;
+    uint8_t m_groups;
+
+    q31_t* m_table;
+    q15_t m_levels[4U];
+
+    uint32_t m_symbols;
+    uint16_t m_silence;
+
+    friend class FSKWaveCache;
+
+    /**
+     * @brief Helper to shift a symbol (or silence) into the history and compute its output samples.
+     * @param symbol Symbol dibit.
+     * @param silent Flag indicating the symbol period is silent.
+     * @param out Output samples, L samples long.
+     */
+    void write(uint8_t symbol, bool silent, q15_t* out);
+    /**
+     * @brief Helper to shift the four symbols of a byte (or four silent symbol periods) into the history,
+     *  without computing their output samples.
+     * @param c Byte to shift.
+     * @param silent Flag indicating the symbol periods are silent.
+     */
+    void shift(uint8_t c, bool silent);
+};
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a cache of the modulated (and filtered) sample blocks of bytes. The samples of a byte
+ *  only depend on the byte and the few bytes (or silent periods) before it that the modulator and filter
+ *  histories span, so a block is keyed by that context and is bit-exact with modulating the byte again.
+ *
+ *  Static patterns (silence, preambles, idle and calibration frames) repeat their contexts, so once a
+ *  pattern has gone out its blocks are copied rather than modulated. A hit also brings the modulator and
+ *  filter histories up to date, so the bytes after it modulate exactly as if nothing had been cached.
+ *  The blocks are taken before the Tx level is applied, so only the symbol levels invalidate them.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API FSKWaveCache {
+public:
+    /**
+     * @brief Initializes a new instance of the FSKWaveCache class.
+     */
+    FSKWaveCache();
+
+    /**
+     * @brief Initializes the cache.
+     * @param modulator Modulator whose output is cached (already initialized).
+     * @param filterState State buffer of the arm_fir_fast_q15() filter after the modulator, or NULL if none.
+     * @param filterTaps Number of filter coefficients, or 0 if none.
+     * @param entries Number of cache entries (a power of 2).
+     * @param keys Entry keys, entries long.
+     * @param samples Entry sample blocks, entries * 4 * L samples long.
+     * @param history Entry filter inputs, entries * 4 * L samples long (or NULL if there is no filter).
+     */
+    void init(FSKModulator* modulator, q15_t* filterState, uint16_t filterTaps, uint16_t entries, uint64_t* keys,
+        q15_t* samples, q15_t* history);
+    /**
+     * @brief Helper to invalidate all of the cache entries (i.e. when the symbol levels change).
+     */
+    void clear();
+
+    /**
+     * @brief Finds the cached samples of a byte (or four silent symbol periods). On a hit the modulator and
+     *  filter histories are advanced past the byte, on a miss the caller modulates it and then calls store().
+     * @param c Byte.
+     * @param silent Flag indicating the symbol periods are silent.
+     * @returns const q15_t* Cached samples, 4 * L samples long, or NULL if the byte is not cached.
+     */
+    const q15_t* find(uint8_t c, bool silent);
+    /**
+     * @brief Stores the samples of the byte last missed by find().
+     * @param samples Output samples, 4 * L samples long.
+     * @param filterInput Filter input samples (modulator output), 4 * L samples long (or NULL if there is no filter).
+     */
+    void store(const q15_t* samples, const q15_t* filterInput);
+    /**
+     * @brief Shifts a byte (or four silent symbol periods) the caller modulates without the cache into
+     *  the context.
+     * @param c Byte.
+     * @param silent Flag indicating the symbol periods are silent.
+     */
+    void skip(uint8_t c, bool silent);
+
+private:
+    FSKModulator* m_modulator;
+    q15_t* m_filterState;
+    uint16_t m_filterHistory;
+
+    uint16_t m_length;
+    uint16_t m_historyLength;
+
+    uint16_t m_entries;
+    uint64_t* m_keys;
+    q15_t* m_samples;
+    q15_t* m_history;
+
+    uint64_t m_context;
+    uint64_t m_contextMask;
+    uint8_t m_contextLength;
+    uint8_t m_warmup;
+    uint16_t m_entry;
+};
+
+#endif // __FSK_MODULATOR_H__
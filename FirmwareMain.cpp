@@ -54,13 +54,16 @@ bool m_duplex = true;
 bool m_tx = false;
 bool m_dcd = false;
 
+/* DMR sample history, shared by the idle (duplex) and DMO (simplex) receivers */
+q15_t dmrRXBuffer[dmr::DMO_BUFFER_LENGTH_SAMPLES];
+
 /* DMR BS */
-dmr::DMRIdleRX dmrIdleRX;
+dmr::DMRIdleRX dmrIdleRX(dmrRXBuffer);
 dmr::DMRRX dmrRX;
 dmr::DMRTX dmrTX;
 
 /* DMR MS-DMO */
-dmr::DMRDMORX dmrDMORX;
+dmr::DMRDMORX dmrDMORX(dmrRXBuffer);
 dmr::DMRDMOTX dmrDMOTX;
 
 /* P25 */
@@ -96,6 +99,9 @@ std::string m_zmqTx = std::string("ipc:///tmp/dvm-tx.ipc");
 
 std::string m_ptyPort = std::string("/dev/ptmx");
 
+uint16_t g_rxBlockSize = RX_BLOCK_SIZE;
+uint16_t g_txLead = TX_LEAD_DEFAULT;
+
 std::string g_logFileName = std::string("dsp.log");
 
 bool g_debug = false;
@@ -353,6 +359,7 @@ void usage(const char* message, const char* arg)
         " [--syslog]" 
         " [-r <ZeroMQ Rx IPC Endpoint>] [-t <ZeroMQ Tx IPC Endpoint>]"
         " [-p <PTY port>]"
+        " [-B <Rx block size>] [-L <Tx lead>]"
         " [-l <log filename>]\n\n"
         "  -b       background process\n"
         "\n"
@@ -364,13 +371,17 @@ void usage(const char* message, const char* arg)
         "\n"
         "  -r       ZeroMQ Rx IPC Endpoint\n"
         "  -t       ZeroMQ Tx IPC Endpoint\n"
+        "           (use shm://<name> for the shared memory transport, see dvm-shm-pipe)\n"
         "\n"
         "  -p       PTY Port\n"
         "\n"
+        "  -B       Rx processing block size in samples (even, 2 - %u)\n"
+        "  -L       Tx lead in milliseconds (0 - 500, default 60)\n"
+        "\n"
         "  -l       Log Filename\n"
         "\n"
         "  --       stop handling options\n",
-        g_progExe.c_str());
+        g_progExe.c_str(), RX_BLOCK_SIZE_MAX);
     exit(EXIT_FAILURE);
 }
 
@@ -422,6 +433,31 @@ int checkArgs(int argc, char* argv[])
 
             p += 2;
         }
+        else if (IS("-B")) {
+            if ((argc - 1) <= 0)
+                usage("error: %s", "must specify the Rx block size");
+            int blockSize = ::atoi(argv[++i]);
+
+            if (blockSize < 2 || blockSize > (int)RX_BLOCK_SIZE_MAX || (blockSize % 2) != 0) {
+                char text[80U];
+                ::snprintf(text, sizeof(text), "Rx block size must be an even number of samples, between 2 and %u!", RX_BLOCK_SIZE_MAX);
+                usage("error: %s", text);
+            }
+            g_rxBlockSize = (uint16_t)blockSize;
+
+            p += 2;
+        }
+        else if (IS("-L")) {
+            if ((argc - 1) <= 0)
+                usage("error: %s", "must specify the Tx lead");
+            int lead = ::atoi(argv[++i]);
+
+            if (lead < 0 || lead > (int)TX_LEAD_MAX)
+                usage("error: %s", "Tx lead must be between 0 and 500ms!");
+            g_txLead = (uint16_t)lead;
+
+            p += 2;
+        }
         else if (IS("-l")) {
             if ((argc - 1) <= 0)
                 usage("error: %s", "must specify the log filename");
@@ -551,6 +587,11 @@ int main(int argc, char** argv)
             ::LogInfo("Portions Copyright (c) 2015-2021 by Jonathan Naylor, G4KLX and others");
 
             ::LogInfoEx("DSP is performing initialization and warmup");
+            io.setRXBlockSize(g_rxBlockSize);
+            ::LogInfoEx("Rx block size %u samples", g_rxBlockSize);
+            io.setTXLead(g_txLead);
+            ::LogInfoEx("Tx lead %ums", g_txLead);
+            ::LogInfoEx("DSP kernels %s", ::arm_math_simd_name());
             setup();
 
             ::LogInfoEx("DSP is up and running");
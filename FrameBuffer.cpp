@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+#include "FrameBuffer.h"
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the FrameBuffer class. */
+
+FrameBuffer::FrameBuffer(uint16_t slotLength, uint16_t frameLength, uint16_t length, bool stamped) :
+    m_slotLength(slotLength),
+    m_frameSlots((frameLength + slotLength - 1U) / slotLength),
+    m_queueSlots(0U),
+    m_slots(0U),
+    m_buffer(NULL),
+    m_lengths(NULL),
+    m_stamps(NULL),
+    m_stamped(stamped),
+    m_head(0U),
+    m_tail(0U),
+    m_used(0U),
+    m_frames(0U),
+    m_reserved(0U),
+    m_reservedLength(0U),
+    m_taken(0U)
+{
+    allocate(length);
+}
+
+/* Finalizes a instance of the FrameBuffer class. */
+
+FrameBuffer::~FrameBuffer()
+{
+    delete[] m_buffer;
+    delete[] m_lengths;
+    delete[] m_stamps;
+}
+
+/* Helper to get how many free slots the buffer has. */
+
+uint16_t FrameBuffer::getSpace() const
+{
+    return m_queueSlots - (m_used - m_taken);
+}
+
+/* Helper to get how many frames are queued. */
+
+uint16_t FrameBuffer::getData() const
+{
+    return m_frames;
+}
+
+/* Helper to drop the queued frames (and any reservation). */
+
+void FrameBuffer::reset()
+{
+    // the queued frames follow the taken frame, so dropping them leaves it the only one in use
+    m_head = m_tail;
+    m_used = m_taken;
+    m_frames = 0U;
+    m_reserved = 0U;
+}
+
+/* Helper to reset and reinitialize data values to defaults. */
+
+void FrameBuffer::reinitialize(uint16_t length)
+{
+    delete[] m_buffer;
+    delete[] m_lengths;
+    delete[] m_stamps;
+
+    allocate(length);
+}
+
+/* Reserves the slots for the next frame. */
+
+uint8_t* FrameBuffer::reserve(uint16_t length)
+{
+    m_reserved = 0U;
+
+    uint16_t slots = (length + m_slotLength - 1U) / m_slotLength;
+    if (slots == 0U || slots > m_frameSlots || slots > getSpace())
+        return NULL;
+
+    // a frame starting in the last slots runs on into the spare slots past them
+    m_reserved = slots;
+    m_reservedLength = length;
+    return m_buffer + m_head * m_slotLength;
+}
+
+/* Queues the reserved frame. */
+
+bool FrameBuffer::commit(uint16_t length, uint32_t stamp)
+{
+    if (m_reserved == 0U || length != m_reservedLength)
+        return false;
+
+    m_lengths[m_head] = length;
+    if (m_stamped)
+        m_stamps[m_head] = stamp;
+
+    m_head += m_reserved;
+    if (m_head >= m_slots)
+        m_head -= m_slots;
+
+    m_used += m_reserved;
+    m_frames++;
+    m_reserved = 0U;
+
+    return true;
+}
+
+/* Takes the oldest queued frame, releasing the frame taken before it. */
+
+const uint8_t* FrameBuffer::get(uint16_t& length)
+{
+    release();
+
+    if (m_frames == 0U)
+        return NULL;
+
+    const uint8_t* frame = m_buffer + m_tail * m_slotLength;
+    length = m_lengths[m_tail];
+
+    m_taken = (length + m_slotLength - 1U) / m_slotLength;
+    m_tail += m_taken;
+    if (m_tail >= m_slots)
+        m_tail -= m_slots;
+
+    m_frames--;
+
+    return frame;
+}
+
+/* Frees the slots of the frame taken by the reader. */
+
+void FrameBuffer::release()
+{
+    m_used -= m_taken;
+    m_taken = 0U;
+}
+
+/* Helper to get the time the oldest queued frame was queued. */
+
+uint32_t FrameBuffer::getStamp() const
+{
+    if (!m_stamped || m_frames == 0U)
+        return 0U;
+
+    return m_stamps[m_tail];
+}
+
+/* Drops the oldest queued frame, without the reader taking it. */
+
+void FrameBuffer::drop()
+{
+    if (m_frames == 0U)
+        return;
+
+    uint16_t slots = (m_lengths[m_tail] + m_slotLength - 1U) / m_slotLength;
+    m_tail += slots;
+    if (m_tail >= m_slots)
+        m_tail -= m_slots;
+
+    m_used -= slots;
+    m_frames--;
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/* Helper to allocate the slots for a buffer length. */
+
+void FrameBuffer::allocate(uint16_t length)
+{
+    m_queueSlots = length / m_slotLength;
+    if (m_queueSlots < m_frameSlots)
+        m_queueSlots = m_frameSlots;
+
+    // the taken frame keeps its slots until it is released, while the queue behind it fills up
+    m_slots = m_queueSlots + m_frameSlots;
+
+    m_buffer = new uint8_t[(m_slots + m_frameSlots - 1U) * m_slotLength];
+    m_lengths = new uint16_t[m_slots];
+    m_stamps = m_stamped ? new uint32_t[m_slots] : NULL;
+
+    m_head = 0U;
+    m_tail = 0U;
+    m_used = 0U;
+    m_frames = 0U;
+    m_reserved = 0U;
+    m_taken = 0U;
+}
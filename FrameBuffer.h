@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file FrameBuffer.h
+ * @ingroup modem_fw
+ * @file FrameBuffer.cpp
+ * @ingroup modem_fw
+ */
+#if !defined(__FRAME_BUFFER_H__)
+#define __FRAME_BUFFER_H__
+
+#include "Defines.h"
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a FIFO of frames held in fixed length slots. A frame longer than a slot takes
+ *  several consecutive slots, and the storage has room for the longest frame past its last slot, so
+ *  every frame is contiguous.
+ *
+ *  A buffer can also stamp each frame with the time it was queued, so the reader can drop frames that
+ *  have waited too long.
+ *
+ *  A writer reserves the slots of the next frame and fills them in place, and the frame is only queued
+ *  once it is committed. A reader takes the oldest frame and reads it in place, and its slots are only
+ *  freed once it is released. The taken frame has room of its own, so it does not count against the
+ *  length of the buffer.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API FrameBuffer {
+public:
+    /**
+     * @brief Initializes a new instance of the FrameBuffer class.
+     * @param slotLength Length of a slot.
+     * @param frameLength Length of the longest frame.
+     * @param length Length of buffer (rounded down to whole slots, and up to the longest frame).
+     * @param stamped Flag indicating each frame is stamped with the time it was queued.
+     */
+    FrameBuffer(uint16_t slotLength, uint16_t frameLength, uint16_t length, bool stamped = false);
+    /**
+     * @brief Finalizes a instance of the FrameBuffer class.
+     */
+    ~FrameBuffer();
+
+    /**
+     * @brief Helper to get how many free slots the buffer has.
+     * @returns uint16_t Number of free slots.
+     */
+    uint16_t getSpace() const;
+    /**
+     * @brief Helper to get how many frames are queued.
+     * @returns uint16_t Number of queued frames.
+     */
+    uint16_t getData() const;
+
+    /**
+     * @brief Helper to drop the queued frames (and any reservation). The frame taken by the reader
+     *  stays valid until it is released.
+     */
+    void reset();
+    /**
+     * @brief Helper to reset and reinitialize data values to defaults.
+     * @param length Length of buffer (rounded down to whole slots, and up to the longest frame).
+     */
+    void reinitialize(uint16_t length);
+
+    /**
+     * @brief Reserves the slots for the next frame.
+     * @param length Length of frame.
+     * @returns uint8_t* Frame to fill, or NULL if the frame is too long or there is not enough space.
+     */
+    uint8_t* reserve(uint16_t length);
+    /**
+     * @brief Queues the reserved frame.
+     * @param length Length of frame (as reserved).
+     * @param stamp Time the frame is queued (ignored unless the buffer is stamped).
+     * @returns bool True, if the frame was queued, otherwise false.
+     */
+    bool commit(uint16_t length, uint32_t stamp = 0U);
+
+    /**
+     * @brief Takes the oldest queued frame, releasing the frame taken before it.
+     * @param[out] length Length of frame.
+     * @returns const uint8_t* Frame, or NULL if no frame is queued.
+     */
+    const uint8_t* get(uint16_t& length);
+    /**
+     * @brief Frees the slots of the frame taken by the reader.
+     */
+    void release();
+
+    /**
+     * @brief Helper to get the time the oldest queued frame was queued.
+     * @returns uint32_t Stamp of the oldest queued frame (or 0 if the buffer is not stamped).
+     */
+    uint32_t getStamp() const;
+    /**
+     * @brief Drops the oldest queued frame, without the reader taking it.
+     */
+    void drop();
+
+private:
+    uint16_t m_slotLength;
+    uint16_t m_frameSlots;
+    uint16_t m_queueSlots;
+    uint16_t m_slots;
+
+    uint8_t* m_buffer;
+    uint16_t* m_lengths;
+    uint32_t* m_stamps;
+    bool m_stamped;
+
+    uint16_t m_head;
+    uint16_t m_tail;
+    uint16_t m_used;
+    uint16_t m_frames;
+
+    uint16_t m_reserved;
+    uint16_t m_reservedLength;
+    uint16_t m_taken;
+
+    /**
+     * @brief Helper to allocate the slots for a buffer length.
+     * @param length Length of buffer.
+     */
+    void allocate(uint16_t length);
+};
+
+#endif // __FRAME_BUFFER_H__
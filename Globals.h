@@ -68,10 +68,9 @@ const uint8_t   MARK_SLOT1 = 0x08U;
 const uint8_t   MARK_SLOT2 = 0x04U;
 const uint8_t   MARK_NONE = 0x00U;
 
-const uint16_t  RX_BLOCK_SIZE = 2U;
-
-const uint16_t  TX_RINGBUFFER_SIZE = 500U;
-const uint16_t  RX_RINGBUFFER_SIZE = 600U;
+// sample ring buffers are power-of-two sized (see SampleBuffer)
+const uint16_t  TX_RINGBUFFER_SIZE = 512U;
+const uint16_t  RX_RINGBUFFER_SIZE = 1024U;
 
 // ---------------------------------------------------------------------------
 //  Macros
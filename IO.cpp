@@ -13,6 +13,10 @@
 #include "Globals.h"
 #include "IO.h"
 
+#if defined(NATIVE_SDR)
+#include <time.h>
+#endif
+
 // ---------------------------------------------------------------------------
 //  Constants
 // ---------------------------------------------------------------------------
@@ -58,9 +62,19 @@ const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
 // Generated using [b, a] = butter(1, 0.001) in MATLAB
 static q31_t DC_FILTER[] = { 3367972, 0, 3367972, 0, 2140747704, 0 }; // {b0, 0, b1, b2, -a1, -a2}
 const uint32_t DC_FILTER_STAGES = 1U; // One Biquad stage
+const uint16_t DC_LEVEL_AVERAGE = 2U; // Number of samples the DC level is averaged over
 
 const uint16_t DC_OFFSET = 2048U;
 
+// Rx filter bank outputs
+const uint8_t RX_BANK_DMR = 0U;
+const uint8_t RX_BANK_P25 = 1U;
+const uint8_t RX_BANK_NXDN = 2U;
+
+// DC blocked filter bank outputs (DMR never uses the DC blocked samples)
+const uint8_t DC_BANK_P25 = 0U;
+const uint8_t DC_BANK_NXDN = 1U;
+
 // ---------------------------------------------------------------------------
 //  Public Class Members
 // ---------------------------------------------------------------------------
@@ -69,14 +83,15 @@ const uint16_t DC_OFFSET = 2048U;
 
 IO::IO() :
     m_started(false),
+#if defined(SEND_RSSI_DATA)
+    m_rxBuffer(RX_RINGBUFFER_SIZE, true),
+#else
     m_rxBuffer(RX_RINGBUFFER_SIZE),
+#endif
     m_txBuffer(TX_RINGBUFFER_SIZE),
-    m_rssiBuffer(RX_RINGBUFFER_SIZE),
-    m_rrc_0_2_Filter(),
-    m_boxcar_5_Filter(),
+    m_rxFilterBank(),
+    m_dcFilterBank(),
     m_dcFilter(),
-    m_rrc_0_2_State(),
-    m_boxcar_5_State(),
     m_dcState(),
     m_pttInvert(false),
     m_rxLevel(128 * 128),
@@ -92,38 +107,30 @@ IO::IO() :
     m_adcOverflow(0U),
     m_dacOverflow(0U),
     m_watchdog(0U),
+#if defined(NATIVE_SDR)
+    m_rxBlockSize(RX_BLOCK_SIZE),
+    m_txLead(TX_LEAD_DEFAULT),
+    m_rxProcessTime(0U),
+    m_rxProcessSamples(0U),
+#endif
     m_lockout(false)
 {
-    ::memset(m_rrc_0_2_State, 0x00U, 70U * sizeof(q15_t));
-    ::memset(m_boxcar_5_State, 0x00U, 30U * sizeof(q15_t));
-
     ::memset(m_dcState, 0x00U, 4U * sizeof(q31_t));
 
-    m_rrc_0_2_Filter.numTaps = RRC_0_2_FILTER_LEN;
-    m_rrc_0_2_Filter.pState = m_rrc_0_2_State;
-    m_rrc_0_2_Filter.pCoeffs = RRC_0_2_FILTER;
-
-    m_boxcar_5_Filter.numTaps = BOXCAR_5_FILTER_LEN;
-    m_boxcar_5_Filter.pState = m_boxcar_5_State;
-    m_boxcar_5_Filter.pCoeffs = BOXCAR_5_FILTER;
-
-#if NXDN_BOXCAR_FILTER
-    ::memset(m_boxcar_10_State, 0x00U, 40U * sizeof(q15_t));
-    
-    m_boxcar_10_Filter.numTaps = BOXCAR10_FILTER_LEN;
-    m_boxcar_10_Filter.pState  = m_boxcar_10_State;
-    m_boxcar_10_Filter.pCoeffs = BOXCAR10_FILTER;
+    // filters are added in RX_BANK_* and DC_BANK_* order
+    m_rxFilterBank.addFilter(RRC_0_2_FILTER, RRC_0_2_FILTER_LEN);
+    m_rxFilterBank.addFilter(BOXCAR_5_FILTER, BOXCAR_5_FILTER_LEN);
+    m_dcFilterBank.addFilter(BOXCAR_5_FILTER, BOXCAR_5_FILTER_LEN);
+#if defined(NXDN_BOXCAR_FILTER)
+    m_rxFilterBank.addFilter(BOXCAR_10_FILTER, BOXCAR_10_FILTER_LEN);
+    m_dcFilterBank.addFilter(BOXCAR_10_FILTER, BOXCAR_10_FILTER_LEN);
 #else
-    ::memset(m_nxdn_0_2_State, 0x00U, 110U * sizeof(q15_t));
-    ::memset(m_nxdn_ISinc_State, 0x00U, 60U * sizeof(q15_t));
-
-    m_nxdn_0_2_Filter.numTaps = NXDN_0_2_FILTER_LEN;
-    m_nxdn_0_2_Filter.pState  = m_nxdn_0_2_State;
-    m_nxdn_0_2_Filter.pCoeffs = NXDN_0_2_FILTER;
-    
-    m_nxdn_ISinc_Filter.numTaps = NXDN_ISINC_FILTER_LEN;
-    m_nxdn_ISinc_Filter.pState  = m_nxdn_ISinc_State;
-    m_nxdn_ISinc_Filter.pCoeffs = NXDN_ISINC_FILTER;
+    m_rxFilterBank.addFilter(NXDN_0_2_FILTER, NXDN_0_2_FILTER_LEN);
+    m_dcFilterBank.addFilter(NXDN_0_2_FILTER, NXDN_0_2_FILTER_LEN);
+#endif
+
+#if !defined(NXDN_BOXCAR_FILTER)
+    m_nxdn_ISinc_Filter.init(NXDN_ISINC_FILTER, NXDN_ISINC_FILTER_LEN, m_nxdn_ISinc_State);
 #endif
 
     m_dcFilter.numStages = DC_FILTER_STAGES;
@@ -197,166 +204,215 @@ void IO::process()
         setPTTInt(m_pttInvert ? true : false);
     }
 
-    if (m_rxBuffer.getData() >= RX_BLOCK_SIZE) {
-        q15_t samples[RX_BLOCK_SIZE];
-        uint8_t control[RX_BLOCK_SIZE];
-        uint16_t rssi[RX_BLOCK_SIZE];
+#if defined(NATIVE_SDR)
+    const uint16_t blockSize = m_rxBlockSize;
+#else
+    const uint16_t blockSize = RX_BLOCK_SIZE;
+#endif
+    if (m_rxBuffer.getData() >= blockSize) {
+#if defined(NATIVE_SDR)
+        // the Rx processing cost is only measured in debug mode, it is not free at small block sizes
+        struct timespec start;
+        if (g_debug)
+            ::clock_gettime(CLOCK_MONOTONIC, &start);
+#endif
+
+        // the block is processed in place; the sample, control and RSSI slots are only
+        // released back to the producer once the block has been fully processed
+        SampleSpan span[2U];
+        m_rxBuffer.peekBlock(blockSize, span[0U], span[1U]);
+
+        q15_t samples[RX_BLOCK_SIZE_MAX];
+        uint8_t* control = span[0U].control;
+        uint16_t* rssi = span[0U].rssi; // NULL, unless the RSSI is sent to the host
+
+        // if the block wraps the end of the ring, gather the control marks and RSSI values
+        uint8_t controlWrap[RX_BLOCK_SIZE_MAX];
+#if defined(SEND_RSSI_DATA)
+        uint16_t rssiWrap[RX_BLOCK_SIZE_MAX];
+#endif
+        if (span[1U].length > 0U) {
+            ::memcpy(controlWrap, span[0U].control, span[0U].length * sizeof(uint8_t));
+            ::memcpy(controlWrap + span[0U].length, span[1U].control, span[1U].length * sizeof(uint8_t));
+            control = controlWrap;
+#if defined(SEND_RSSI_DATA)
+            ::memcpy(rssiWrap, span[0U].rssi, span[0U].length * sizeof(uint16_t));
+            ::memcpy(rssiWrap + span[0U].length, span[1U].rssi, span[1U].length * sizeof(uint16_t));
+            rssi = rssiWrap;
+#endif
+        }
 
-        for (uint16_t i = 0U; i < RX_BLOCK_SIZE; i++) {
-            uint16_t sample;
-            m_rxBuffer.get(sample, control[i]);
-            m_rssiBuffer.get(rssi[i]);
+        uint16_t n = 0U;
+        for (uint8_t s = 0U; s < 2U; s++) {
+            for (uint16_t i = 0U; i < span[s].length; i++, n++) {
+                uint16_t sample = span[s].samples[i];
 
-            // Detect ADC overflow
-            if (m_detect && (sample == 0U || sample == 4095U))
-                m_adcOverflow++;
+                // Detect ADC overflow
+                if (m_detect && (sample == 0U || sample == 4095U))
+                    m_adcOverflow++;
 
-            q15_t res1 = q15_t(sample) - m_rxDCOffset;
-            q31_t res2 = res1 * m_rxLevel;
-            samples[i] = q15_t(__SSAT((res2 >> 15), 16));
+                q15_t res1 = q15_t(sample) - m_rxDCOffset;
+                q31_t res2 = res1 * m_rxLevel;
+                samples[n] = q15_t(__SSAT((res2 >> 15), 16));
+            }
         }
 
-        if (m_lockout)
+        if (m_lockout) {
+            m_rxBuffer.consume(blockSize);
             return;
+        }
 
-        q15_t dcSamples[RX_BLOCK_SIZE];
+        q15_t dcSamples[RX_BLOCK_SIZE_MAX];
         if (m_dcBlockerEnable) {
-            q31_t q31Samples[RX_BLOCK_SIZE];
+            q31_t q31Samples[RX_BLOCK_SIZE_MAX];
+
+            ::arm_q15_to_q31(samples, q31Samples, blockSize);
 
-            ::arm_q15_to_q31(samples, q31Samples, RX_BLOCK_SIZE);
+            q31_t dcValues[RX_BLOCK_SIZE_MAX];
+            ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, blockSize);
 
-            q31_t dcValues[RX_BLOCK_SIZE];
-            ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, RX_BLOCK_SIZE);
+            // the DC level is averaged over fixed groups of samples, so the corrected samples
+            // do not depend on the Rx block size
+            for (uint16_t i = 0U; i < blockSize; i += DC_LEVEL_AVERAGE) {
+                q31_t dcLevel = 0;
+                for (uint16_t j = 0U; j < DC_LEVEL_AVERAGE; j++)
+                    dcLevel += dcValues[i + j];
+                dcLevel /= DC_LEVEL_AVERAGE;
 
-            q31_t dcLevel = 0;
-            for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
-                dcLevel += dcValues[i];
-            dcLevel /= RX_BLOCK_SIZE;
+                q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));
 
-            q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));;
+                for (uint16_t j = 0U; j < DC_LEVEL_AVERAGE; j++)
+                    dcSamples[i + j] = samples[i + j] - offset;
+            }
+        }
 
-            for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
-                dcSamples[i] = samples[i] - offset;
+        // run every protocol filter needed in this state over each input in one pass, the banks are fed
+        // every block (even if no output is taken) so their sample history stays continuous
+        bool idle = m_modemState == STATE_IDLE;
+        bool dmrFilter = m_dmrEnable && (idle || m_modemState == STATE_DMR);
+        bool p25Filter = m_p25Enable && (idle || m_modemState == STATE_P25);
+        bool nxdnFilter = m_nxdnEnable && (idle || m_modemState == STATE_NXDN);
+
+        q15_t dmrSamples[RX_BLOCK_SIZE_MAX];
+        q15_t p25Samples[RX_BLOCK_SIZE_MAX];
+        q15_t nxdnSamples[RX_BLOCK_SIZE_MAX];
+
+        q15_t* rxOutputs[FIR_BANK_FILTERS_MAX] = { NULL, NULL, NULL };
+        q15_t* dcOutputs[FIR_BANK_FILTERS_MAX] = { NULL, NULL, NULL };
+        if (dmrFilter)
+            rxOutputs[RX_BANK_DMR] = dmrSamples;
+        if (m_dcBlockerEnable) {
+            if (p25Filter)
+                dcOutputs[DC_BANK_P25] = p25Samples;
+            if (nxdnFilter)
+                dcOutputs[DC_BANK_NXDN] = nxdnSamples;
         }
+        else {
+            if (p25Filter)
+                rxOutputs[RX_BANK_P25] = p25Samples;
+            if (nxdnFilter)
+                rxOutputs[RX_BANK_NXDN] = nxdnSamples;
+        }
+
+        m_rxFilterBank.process(samples, rxOutputs, blockSize);
+        if (m_dcBlockerEnable)
+            m_dcFilterBank.process(dcSamples, dcOutputs, blockSize);
+
+#if !defined(NXDN_BOXCAR_FILTER)
+        if (nxdnFilter)
+            m_nxdn_ISinc_Filter.process(nxdnSamples, nxdnSamples, blockSize);
+#endif
 
         /** Idle Modem State */
         if (m_modemState == STATE_IDLE) {
             /** Project 25 */
             if (m_p25Enable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-
-                p25RX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                p25RX.samples(p25Samples, rssi, blockSize);
             }
 
             /** Digital Mobile Radio */
             if (m_dmrEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                ::arm_fir_fast_q15(&m_rrc_0_2_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-
-                if (m_dmrEnable) {
-                    if (m_duplex)
-                        dmrIdleRX.samples(c4fmSamples, RX_BLOCK_SIZE);
-                    else
-                        dmrDMORX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
-                }
+                if (m_duplex)
+                    dmrIdleRX.samples(dmrSamples, blockSize);
+                else
+                    dmrDMORX.samples(dmrSamples, rssi, blockSize);
             }
 
             /** Next Generation Digital Narrowband */
             if (m_nxdnEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-#if NXDN_BOXCAR_FILTER
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-#else
-                q15_t c4fmRCSamples[RX_BLOCK_SIZE];
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, dcSamples, c4fmRCSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, samples, c4fmRCSamples, RX_BLOCK_SIZE);
-                }
-
-                ::arm_fir_fast_q15(&m_nxdn_ISinc_Filter, c4fmRCSamples, c4fmSamples, RX_BLOCK_SIZE);
-#endif
-                nxdnRX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                nxdnRX.samples(nxdnSamples, rssi, blockSize);
             }
         }
         else if (m_modemState == STATE_DMR) {        // DMR State
             /** Digital Mobile Radio */
             if (m_dmrEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                ::arm_fir_fast_q15(&m_rrc_0_2_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-
                 if (m_duplex) {
                     // If the transmitter isn't on, use the DMR idle RX to detect the wakeup CSBKs
                     if (m_tx)
-                        dmrRX.samples(c4fmSamples, rssi, control, RX_BLOCK_SIZE);
+                        dmrRX.samples(dmrSamples, rssi, control, blockSize);
                     else
-                        dmrIdleRX.samples(c4fmSamples, RX_BLOCK_SIZE);
+                        dmrIdleRX.samples(dmrSamples, blockSize);
                 }
                 else {
-                    dmrDMORX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                    dmrDMORX.samples(dmrSamples, rssi, blockSize);
                 }
             }
         }
         else if (m_modemState == STATE_P25) {        // P25 State
             /** Project 25 */
             if (m_p25Enable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-
-                p25RX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                p25RX.samples(p25Samples, rssi, blockSize);
             }
         }
         else if (m_modemState == STATE_NXDN) {       // NXDN State
             /** Next Generation Digital Narrowband */
             if (m_nxdnEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-#if NXDN_BOXCAR_FILTER
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
-                }
-#else
-                q15_t c4fmRCSamples[RX_BLOCK_SIZE];
-                if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, dcSamples, c4fmRCSamples, RX_BLOCK_SIZE);
-                }
-                else {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, samples, c4fmRCSamples, RX_BLOCK_SIZE);
-                }
-
-                ::arm_fir_fast_q15(&m_nxdn_ISinc_Filter, c4fmRCSamples, c4fmSamples, RX_BLOCK_SIZE);
-#endif
-                nxdnRX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                nxdnRX.samples(nxdnSamples, rssi, blockSize);
             }
         }
         else if (m_modemState == STATE_RSSI_CAL) {
-            calRSSI.samples(rssi, RX_BLOCK_SIZE);
+#if defined(SEND_RSSI_DATA)
+            calRSSI.samples(rssi, blockSize);
+#endif
+        }
+
+        m_rxBuffer.consume(blockSize);
+
+#if defined(NATIVE_SDR)
+        if (g_debug) {
+            struct timespec end;
+            ::clock_gettime(CLOCK_MONOTONIC, &end);
+
+            // report the average Rx processing cost every 10 seconds worth of samples
+            m_rxProcessTime += uint64_t(end.tv_sec - start.tv_sec) * 1000000000ULL + (end.tv_nsec - start.tv_nsec);
+            m_rxProcessSamples += blockSize;
+            if (m_rxProcessSamples >= 240000U) {
+                ::LogDebug("IO::process() Rx block size %u, %.1f ns/sample", blockSize, double(m_rxProcessTime) / m_rxProcessSamples);
+
+                m_rxProcessTime = 0U;
+                m_rxProcessSamples = 0U;
+            }
         }
+#endif
     }
 }
 
+#if defined(NATIVE_SDR)
+/* Sets the number of samples processed per Rx block. */
+
+bool IO::setRXBlockSize(uint16_t blockSize)
+{
+    if (blockSize < DC_LEVEL_AVERAGE || blockSize > RX_BLOCK_SIZE_MAX || (blockSize % DC_LEVEL_AVERAGE) != 0U)
+        return false;
+
+    m_rxBlockSize = blockSize;
+    return true;
+}
+#endif
+
 /* Write samples to air interface. */
 
-void IO::write(DVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* control)
+void IO::write(DVM_STATE mode, const q15_t* samples, uint16_t length, const uint8_t* control)
 {
     if (!m_started)
         return;
@@ -386,20 +442,27 @@ void IO::write(DVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* c
         break;
     }
 
-    for (uint16_t i = 0U; i < length; i++) {
-        q31_t res1 = samples[i] * txLevel;
-        q15_t res2 = q15_t(__SSAT((res1 >> 15), 16));
-        uint16_t res3 = uint16_t(res2 + m_txDCOffset);
+    // write the samples directly into the ring; anything that does not fit is dropped and flagged as an overflow
+    SampleSpan span[2U];
+    uint16_t count = m_txBuffer.putBlock(length, span[0U], span[1U]);
+
+    uint16_t n = 0U;
+    for (uint8_t s = 0U; s < 2U; s++) {
+        for (uint16_t i = 0U; i < span[s].length; i++, n++) {
+            q31_t res1 = samples[n] * txLevel;
+            q15_t res2 = q15_t(__SSAT((res1 >> 15), 16));
+            uint16_t res3 = uint16_t(res2 + m_txDCOffset);
 
-        // Detect DAC overflow
-        if (res3 > 4095U)
-            m_dacOverflow++;
+            // Detect DAC overflow
+            if (res3 > 4095U)
+                m_dacOverflow++;
 
-        if (control == NULL)
-            m_txBuffer.put(res3, MARK_NONE);
-        else
-            m_txBuffer.put(res3, control[i]);
+            span[s].samples[i] = res3;
+            span[s].control[i] = (control == NULL) ? MARK_NONE : control[n];
+        }
     }
+
+    m_txBuffer.commit(count);
 }
 
 /* Helper to get how much space the transmit ring buffer has for samples. */
@@ -24,7 +24,7 @@
 #include "Defines.h"
 #include "Globals.h"
 #include "SampleBuffer.h"
-#include "RSSIBuffer.h"
+#include "FIRFilter.h"
 
 // ---------------------------------------------------------------------------
 //  Class Declaration
@@ -61,6 +61,21 @@ public:
      */
     void process();
 
+#if defined(NATIVE_SDR)
+    /**
+     * @brief Sets the number of samples processed per Rx block.
+     * @param blockSize Number of samples (must be a multiple of 2, and no larger than RX_BLOCK_SIZE_MAX).
+     * @returns bool True, if the block size was set, otherwise false.
+     */
+    bool setRXBlockSize(uint16_t blockSize);
+    /**
+     * @brief Sets how far ahead of its on-air time each Tx frame is released to the SDR.
+     * @param lead Tx lead in milliseconds (no larger than TX_LEAD_MAX).
+     * @returns bool True, if the Tx lead was set, otherwise false.
+     */
+    bool setTXLead(uint16_t lead);
+#endif
+
     /**
      * @brief Write samples to air interface.
      * @param mode 
@@ -68,7 +83,7 @@ public:
      * @param length Length of samples buffer.
      * @param control 
      */
-    void write(DVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* control = NULL);
+    void write(DVM_STATE mode, const q15_t* samples, uint16_t length, const uint8_t* control = NULL);
 
     /**
      * @brief Helper to get how much space the transmit ring buffer has for samples.
@@ -223,26 +238,16 @@ private:
 
     SampleBuffer m_rxBuffer;
     SampleBuffer m_txBuffer;
-    RSSIBuffer m_rssiBuffer;
 
-    arm_fir_instance_q15 m_rrc_0_2_Filter;
-    arm_fir_instance_q15 m_boxcar_5_Filter;
+    FIRFilterBank m_rxFilterBank;                       // DMR, P25 and NXDN filters, on the Rx samples
+    FIRFilterBank m_dcFilterBank;                       // P25 and NXDN filters, on the DC blocked Rx samples
 
     arm_biquad_casd_df1_inst_q31 m_dcFilter;
 
-    q15_t m_rrc_0_2_State[70U];      // NoTaps + BlockSize - 1, 42 + 20 - 1 plus some spare
-    q15_t m_boxcar_5_State[30U];     // NoTaps + BlockSize - 1, 6 + 20 - 1 plus some spare
+#if !defined(NXDN_BOXCAR_FILTER)
+    FIRFilter m_nxdn_ISinc_Filter;
 
-#if NXDN_BOXCAR_FILTER
-    arm_fir_instance_q15 m_boxcar_10_Filter;
-
-    q15_t m_boxcar_10_State[40U];   // NoTaps + BlockSize - 1, 10 + 20 - 1 plus some spare
-#else
-    arm_fir_instance_q15 m_nxdn_0_2_Filter;
-    arm_fir_instance_q15 m_nxdn_ISinc_Filter;
-    
-    q15_t m_nxdn_0_2_State[110U];   // NoTaps + BlockSize - 1, 82 + 20 - 1 plus some spare
-    q15_t m_nxdn_ISinc_State[60U];  // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
+    q15_t m_nxdn_ISinc_State[64U];                      // 2 * NoTaps, 2 * 32
 #endif
 
     q31_t m_dcState[4];
@@ -268,6 +273,14 @@ private:
 
     volatile uint32_t m_watchdog;
 
+#if defined(NATIVE_SDR)
+    uint16_t m_rxBlockSize;
+    uint16_t m_txLead;
+
+    uint64_t m_rxProcessTime;
+    uint32_t m_rxProcessSamples;
+#endif
+
     bool m_lockout;
 
     // Hardware specific routines
@@ -334,6 +347,10 @@ private:
      * @param interruptRx 
      */
     void interruptRx();
+    /**
+     * @brief Receives samples from the shared memory baseband transport.
+     */
+    void interruptRxShm();
     /**
      * @brief 
      * @param arg 
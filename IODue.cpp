@@ -77,11 +77,10 @@ void IO::interrupt()
         DACC->DACC_CDR = sample;
 
         sample = ADC->ADC_CDR[ADC_CDR_Chan];
-        m_rxBuffer.put(sample, control);
 #if defined(SEND_RSSI_DATA)
-        m_rssiBuffer.put(ADC->ADC_CDR[RSSI_CDR_Chan]);
+        m_rxBuffer.put(sample, control, ADC->ADC_CDR[RSSI_CDR_Chan]);
 #else
-        m_rssiBuffer.put(0U);
+        m_rxBuffer.put(sample, control, 0U);
 #endif
         m_watchdog++;
     }
@@ -479,8 +479,7 @@ void IO::interrupt()
     ADC_ClearFlag(ADC1, ADC_FLAG_EOC);
     ADC_SoftwareStartConv(ADC1);
 
-    m_rxBuffer.put(sample, control);
-    m_rssiBuffer.put(rawRSSI);
+    m_rxBuffer.put(sample, control, rawRSSI);
 
     m_watchdog++;
 }
@@ -1,109 +0,0 @@
-// SPDX-License-Identifier: GPL-2.0-only
-/*
- * Digital Voice Modem - Modem Firmware
- * GPLv2 Open Source. Use is subject to license terms.
- * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
- *
- *  Copyright (C) 2015,2016 Jonathan Naylor, G4KLX
- *  Serial FIFO Control Copyright (C) 2015 by James McLaughlin, KI6ZUM
- *
- */
-#include "RSSIBuffer.h"
-
-// ---------------------------------------------------------------------------
-//  Public Class Members
-// ---------------------------------------------------------------------------
-
-/* Initializes a new instance of the RSSIBuffer class. */
-
-RSSIBuffer::RSSIBuffer(uint16_t length) :
-    m_length(length),
-    m_rssi(NULL),
-    m_head(0U),
-    m_tail(0U),
-    m_full(false),
-    m_overflow(false)
-{
-    m_rssi = new uint16_t[length];
-}
-
-/* Helper to get how much space the ring buffer has for samples. */
-
-uint16_t RSSIBuffer::getSpace() const
-{
-    uint16_t n = 0U;
-
-    if (m_tail == m_head)
-        n = m_full ? 0U : m_length;
-    else if (m_tail < m_head)
-        n = m_length - m_head + m_tail;
-    else
-        n = m_tail - m_head;
-
-    if (n > m_length)
-        n = 0U;
-
-    return n;
-}
-
-/* */
-
-uint16_t RSSIBuffer::getData() const
-{
-    if (m_tail == m_head)
-        return m_full ? m_length : 0U;
-    else if (m_tail < m_head)
-        return m_head - m_tail;
-    else
-        return m_length - m_tail + m_head;
-}
-
-/* */
-
-bool RSSIBuffer::put(uint16_t rssi)
-{
-    if (m_full) {
-        m_overflow = true;
-        return false;
-    }
-
-    m_rssi[m_head] = rssi;
-
-    m_head++;
-    if (m_head >= m_length)
-        m_head = 0U;
-
-    if (m_head == m_tail)
-        m_full = true;
-
-    return true;
-}
-
-/* */
-
-bool RSSIBuffer::get(uint16_t& rssi)
-{
-    if (m_head == m_tail && !m_full)
-        return false;
-
-    rssi = m_rssi[m_tail];
-
-    m_full = false;
-
-    m_tail++;
-    if (m_tail >= m_length)
-        m_tail = 0U;
-
-    return true;
-}
-
-/* Flag indicating whether or not the ring buffer has overflowed. */
-
-bool RSSIBuffer::hasOverflowed()
-{
-    bool overflow = m_overflow;
-
-    m_overflow = false;
-
-    return overflow;
-}
@@ -16,98 +16,158 @@
 
 /* Initializes a new instance of the SampleBuffer class. */
 
-SampleBuffer::SampleBuffer(uint16_t length) :
-    m_length(length),
+SampleBuffer::SampleBuffer(uint16_t length, bool rssi) :
+    m_length(1U),
+    m_mask(0U),
     m_samples(NULL),
     m_control(NULL),
+    m_rssi(NULL),
     m_head(0U),
     m_tail(0U),
-    m_full(false),
     m_overflow(false)
 {
-    m_samples = new uint16_t[length];
-    m_control = new uint8_t[length];
+    // round up to the next power of two (free-running 16-bit indices limit this to 32768)
+    while (m_length < length && m_length < 0x8000U)
+        m_length <<= 1;
+    m_mask = m_length - 1U;
+
+    m_samples = new uint16_t[m_length];
+    m_control = new uint8_t[m_length];
+    if (rssi)
+        m_rssi = new uint16_t[m_length];
 }
 
 /* Helper to get how much space the ring buffer has for samples. */
 
 uint16_t SampleBuffer::getSpace() const
 {
-    uint16_t n = 0U;
-
-    if (m_tail == m_head)
-        n = m_full ? 0U : m_length;
-    else if (m_tail < m_head)
-        n = m_length - m_head + m_tail;
-    else
-        n = m_tail - m_head;
-
-    if (n > m_length)
-        n = 0U;
-
-    return n;
+    return m_length - getData();
 }
 
-/* */
+/* Helper to get how many samples are stored in the ring buffer. */
 
 uint16_t SampleBuffer::getData() const
 {
-    if (m_tail == m_head)
-        return m_full ? m_length : 0U;
-    else if (m_tail < m_head)
-        return m_head - m_tail;
-    else
-        return m_length - m_tail + m_head;
+    uint16_t tail = m_tail.load(std::memory_order_acquire);
+    uint16_t head = m_head.load(std::memory_order_acquire);
+    return uint16_t(head - tail);
 }
 
-/* */
+/* Writes a sample to the ring buffer. */
 
-bool SampleBuffer::put(uint16_t sample, uint8_t control)
+bool SampleBuffer::put(uint16_t sample, uint8_t control, uint16_t rssi)
 {
-    if (m_full) {
-        m_overflow = true;
+    uint16_t head = m_head.load(std::memory_order_relaxed);
+    uint16_t tail = m_tail.load(std::memory_order_acquire);
+
+    if (uint16_t(head - tail) >= m_length) {
+        m_overflow.store(true, std::memory_order_relaxed);
         return false;
     }
 
-    m_samples[m_head] = sample;
-    m_control[m_head] = control;
-
-    m_head++;
-    if (m_head >= m_length)
-        m_head = 0U;
-
-    if (m_head == m_tail)
-        m_full = true;
+    m_samples[head & m_mask] = sample;
+    m_control[head & m_mask] = control;
+    if (m_rssi != NULL)
+        m_rssi[head & m_mask] = rssi;
 
+    // publish the sample to the consumer
+    m_head.store(uint16_t(head + 1U), std::memory_order_release);
     return true;
 }
 
-/* */
+/* Reads a sample from the ring buffer. */
 
 bool SampleBuffer::get(uint16_t& sample, uint8_t& control)
 {
-    if (m_head == m_tail && !m_full)
+    uint16_t tail = m_tail.load(std::memory_order_relaxed);
+    uint16_t head = m_head.load(std::memory_order_acquire);
+
+    if (head == tail)
         return false;
 
-    sample = m_samples[m_tail];
-    control = m_control[m_tail];
+    sample = m_samples[tail & m_mask];
+    control = m_control[tail & m_mask];
 
-    m_full = false;
+    // release the slot back to the producer
+    m_tail.store(uint16_t(tail + 1U), std::memory_order_release);
+    return true;
+}
 
-    m_tail++;
-    if (m_tail >= m_length)
-        m_tail = 0U;
+/* Reserves up to the given number of free slots for writing. */
 
-    return true;
+uint16_t SampleBuffer::putBlock(uint16_t length, SampleSpan& first, SampleSpan& second)
+{
+    uint16_t head = m_head.load(std::memory_order_relaxed);
+    uint16_t tail = m_tail.load(std::memory_order_acquire);
+
+    uint16_t space = m_length - uint16_t(head - tail);
+    if (length > space) {
+        m_overflow.store(true, std::memory_order_relaxed);
+        length = space;
+    }
+
+    split(head, length, first, second);
+    return length;
+}
+
+/* Publishes slots previously reserved by putBlock() to the consumer. */
+
+void SampleBuffer::commit(uint16_t length)
+{
+    uint16_t head = m_head.load(std::memory_order_relaxed);
+    m_head.store(uint16_t(head + length), std::memory_order_release);
+}
+
+/* Returns up to the given number of stored slots without removing them. */
+
+uint16_t SampleBuffer::peekBlock(uint16_t length, SampleSpan& first, SampleSpan& second)
+{
+    uint16_t tail = m_tail.load(std::memory_order_relaxed);
+    uint16_t head = m_head.load(std::memory_order_acquire);
+
+    uint16_t data = uint16_t(head - tail);
+    if (length > data)
+        length = data;
+
+    split(tail, length, first, second);
+    return length;
+}
+
+/* Releases slots previously returned by peekBlock() back to the producer. */
+
+void SampleBuffer::consume(uint16_t length)
+{
+    uint16_t tail = m_tail.load(std::memory_order_relaxed);
+    m_tail.store(uint16_t(tail + length), std::memory_order_release);
 }
 
 /* Flag indicating whether or not the ring buffer has overflowed. */
 
 bool SampleBuffer::hasOverflowed()
 {
-    bool overflow = m_overflow;
+    return m_overflow.exchange(false, std::memory_order_relaxed);
+}
 
-    m_overflow = false;
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
 
-    return overflow;
+/* Helper to split a run of slots starting at the given index into contiguous spans. */
+
+void SampleBuffer::split(uint16_t index, uint16_t length, SampleSpan& first, SampleSpan& second) const
+{
+    uint16_t offset = index & m_mask;
+    uint16_t run = m_length - offset;
+    if (run > length)
+        run = length;
+
+    first.samples = m_samples + offset;
+    first.control = m_control + offset;
+    first.rssi = (m_rssi != NULL) ? m_rssi + offset : NULL;
+    first.length = run;
+
+    second.samples = m_samples;
+    second.control = m_control;
+    second.rssi = m_rssi;
+    second.length = length - run;
 }
@@ -19,21 +19,49 @@
 
 #include "Defines.h"
 
+#include <atomic>
+
+// ---------------------------------------------------------------------------
+//  Structure Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Describes a contiguous run of slots within a SampleBuffer.
+ * @ingroup modem_fw
+ */
+struct SampleSpan {
+    uint16_t* samples;              //!< Sample values.
+    uint8_t* control;               //!< Control marks.
+    uint16_t* rssi;                 //!< RSSI values (NULL if the buffer does not carry RSSI).
+    uint16_t length;                //!< Number of slots in this run.
+};
+
 // ---------------------------------------------------------------------------
 //  Class Declaration
 // ---------------------------------------------------------------------------
 
 /**
- * @brief Implements a circular ring buffer for sample data.
+ * @brief Implements a wait-free single-producer/single-consumer ring buffer for sample data.
  * @ingroup modem_fw
+ * 
+ *  Each slot holds a sample, its control mark and (optionally) its RSSI value, all sharing a single
+ *  head/tail pair. The head index is only ever written by the producer and the tail index is only
+ *  ever written by the consumer. Both are free-running counters masked into the power-of-two sized
+ *  storage, so no shared "full" flag (or lock) is required between the two sides.
+ * 
+ *  Besides the per-sample put()/get() calls, the ring exposes a block interface; putBlock()/commit()
+ *  on the producer side and peekBlock()/consume() on the consumer side. These hand out up to two
+ *  contiguous spans (the second span is only used when the block wraps the end of the storage) so
+ *  data may be written or processed in place.
  */
 class DSP_FW_API SampleBuffer {
 public:
     /**
      * @brief Initializes a new instance of the SampleBuffer class.
-     * @param length Length of buffer.
+     * @param length Length of buffer (rounded up to the next power of two).
+     * @param rssi Flag indicating whether or not the buffer also stores RSSI values.
      */
-    SampleBuffer(uint16_t length);
+    SampleBuffer(uint16_t length, bool rssi = false);
 
     /**
      * @brief Helper to get how much space the ring buffer has for samples.
@@ -42,27 +70,57 @@ public:
     uint16_t getSpace() const;
 
     /**
-     * @brief 
-     * @returns uint16_t 
+     * @brief Helper to get how many samples are stored in the ring buffer.
+     * @returns uint16_t Amount of samples stored in the ring buffer.
      */
     uint16_t getData() const;
 
     /**
-     * @brief 
-     * @param sample 
-     * @param control
-     * @returns bool 
+     * @brief Writes a sample to the ring buffer. (Producer side only.)
+     * @param sample Sample value.
+     * @param control Control mark for the sample.
+     * @param rssi RSSI value for the sample.
+     * @returns bool True, if sample was written, otherwise false.
      */
-    bool put(uint16_t sample, uint8_t control);
+    bool put(uint16_t sample, uint8_t control, uint16_t rssi = 0U);
 
     /**
-     * @brief 
-     * @param[out] sample
-     * @param[out] control
-     * @returns bool 
+     * @brief Reads a sample from the ring buffer. (Consumer side only.)
+     * @param[out] sample Sample value.
+     * @param[out] control Control mark for the sample.
+     * @returns bool True, if a sample was read, otherwise false.
      */
     bool get(uint16_t& sample, uint8_t& control);
 
+    /**
+     * @brief Reserves up to the given number of free slots for writing. (Producer side only.)
+     *  The reserved slots are not visible to the consumer until they are published with commit().
+     * @param length Number of slots requested.
+     * @param[out] first First contiguous span of reserved slots.
+     * @param[out] second Second contiguous span of reserved slots (zero length if the block does not wrap).
+     * @returns uint16_t Number of slots reserved.
+     */
+    uint16_t putBlock(uint16_t length, SampleSpan& first, SampleSpan& second);
+    /**
+     * @brief Publishes slots previously reserved by putBlock() to the consumer. (Producer side only.)
+     * @param length Number of slots to publish.
+     */
+    void commit(uint16_t length);
+
+    /**
+     * @brief Returns up to the given number of stored slots without removing them. (Consumer side only.)
+     * @param length Number of slots requested.
+     * @param[out] first First contiguous span of stored slots.
+     * @param[out] second Second contiguous span of stored slots (zero length if the block does not wrap).
+     * @returns uint16_t Number of slots returned.
+     */
+    uint16_t peekBlock(uint16_t length, SampleSpan& first, SampleSpan& second);
+    /**
+     * @brief Releases slots previously returned by peekBlock() back to the producer. (Consumer side only.)
+     * @param length Number of slots to release.
+     */
+    void consume(uint16_t length);
+
     /**
      * @brief Flag indicating whether or not the ring buffer has overflowed.
      * @returns bool Flag indicating whether or not the ring buffer has overflowed.
@@ -71,15 +129,24 @@ public:
 
 private:
     uint16_t m_length;
-    volatile uint16_t* m_samples;
-    volatile uint8_t* m_control;
+    uint16_t m_mask;
+    uint16_t* m_samples;
+    uint8_t* m_control;
+    uint16_t* m_rssi;
 
-    volatile uint16_t m_head;
-    volatile uint16_t m_tail;
+    std::atomic<uint16_t> m_head;
+    std::atomic<uint16_t> m_tail;
 
-    volatile bool m_full;
+    std::atomic<bool> m_overflow;
 
-    bool m_overflow;
+    /**
+     * @brief Helper to split a run of slots starting at the given index into contiguous spans.
+     * @param index Free-running index of the first slot.
+     * @param length Number of slots.
+     * @param[out] first First contiguous span.
+     * @param[out] second Second contiguous span.
+     */
+    void split(uint16_t index, uint16_t length, SampleSpan& first, SampleSpan& second) const;
 };
 
 #endif // __SAMPLE_RB_H__
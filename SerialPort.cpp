@@ -32,6 +32,7 @@ SerialPort::SerialPort() :
     m_ptr(0U),
     m_len(0U),
     m_dblFrame(false),
+    m_txData(NULL),
     m_debug(false),
     m_repeat()
 {
@@ -59,6 +60,7 @@ void SerialPort::process()
                 m_ptr = 1U;
                 m_len = 0U;
                 m_dblFrame = false;
+                m_txData = NULL;
             }
             else if (c == DVM_LONG_FRAME_START) {
                 // Handle the frame start correctly
@@ -66,6 +68,7 @@ void SerialPort::process()
                 m_ptr = 1U;
                 m_len = 0U;
                 m_dblFrame = true;
+                m_txData = NULL;
             }
             else {
                 m_ptr = 0U;
@@ -95,16 +98,22 @@ void SerialPort::process()
             m_ptr = 3U;
         }
         else {
-            // Any other bytes are added to the buffer
-            m_buffer[m_ptr] = c;
+            // Any other bytes are added to the buffer, the data of a Tx data frame goes straight
+            // into the Tx FIFO
+            uint16_t offset = m_dblFrame ? 3U : 2U;
+            if (m_txData != NULL && m_ptr > (offset + 1U))
+                m_txData[m_ptr - (offset + 2U)] = c;
+            else
+                m_buffer[m_ptr] = c;
             m_ptr++;
 
+            // Once the flag byte is in (it may select the Tx FIFO) the rest of the frame is reserved
+            if (m_ptr == (offset + 2U) && m_ptr < m_len)
+                m_txData = reserveTxData(m_buffer[offset], c);
+
             // The full packet has been received, process it
             if (m_ptr == m_len) {
                 uint8_t err = 2U;
-                uint8_t offset = 2U;
-                if (m_dblFrame)
-                    offset = 3U;
 
                 // DEBUG4("m_buffer [b0 - b2]", m_buffer[0], m_buffer[1], m_buffer[2]);
                 // DEBUG4("m_buffer [b3 - b5]", m_buffer[3], m_buffer[4], m_buffer[5]);
@@ -220,7 +229,9 @@ void SerialPort::process()
                 case CMD_DMR_DATA1:
                     if (m_dmrEnable) {
                         if (m_modemState == STATE_IDLE || m_modemState == STATE_DMR) {
-                            if (m_duplex)
+                            if (m_duplex && m_txData != NULL)
+                                err = dmrTX.commitData1(m_len - 3U);
+                            else if (m_duplex)
                                 err = dmrTX.writeData1(m_buffer + 3U, m_len - 3U);
                         }
                     }
@@ -237,8 +248,12 @@ void SerialPort::process()
                 case CMD_DMR_DATA2:
                     if (m_dmrEnable) {
                         if (m_modemState == STATE_IDLE || m_modemState == STATE_DMR) {
-                            if (m_duplex)
+                            if (m_duplex && m_txData != NULL)
+                                err = dmrTX.commitData2(m_len - 3U);
+                            else if (m_duplex)
                                 err = dmrTX.writeData2(m_buffer + 3U, m_len - 3U);
+                            else if (m_txData != NULL)
+                                err = dmrDMOTX.commitData(m_len - 3U);
                             else
                                 err = dmrDMOTX.writeData(m_buffer + 3U, m_len - 3U);
                         }
@@ -307,6 +322,15 @@ void SerialPort::process()
                     }
                     break;
 
+                case CMD_DMR_TX_MAX_AGE:
+                    if (m_dmrEnable)
+                        err = dmrTX.setMaxQueueAge(m_buffer + 3U, m_len - 3U);
+                    if (err != RSN_OK) {
+                        DEBUG2("SerialPort::process() received invalid DMR Tx queue maximum age", err);
+                        sendNAK(err);
+                    }
+                    break;
+
                 case CMD_DMR_CLEAR1:
                     if (m_dmrEnable) {
                         if (m_modemState == STATE_IDLE || m_modemState == STATE_P25)
@@ -324,7 +348,9 @@ void SerialPort::process()
                 case CMD_P25_DATA:
                     if (m_p25Enable) {
                         if (m_modemState == STATE_IDLE || m_modemState == STATE_P25) {
-                            if (m_dblFrame)
+                            if (m_txData != NULL)
+                                err = p25TX.commitData(m_buffer[offset + 1U], m_len - (offset + 1U));
+                            else if (m_dblFrame)
                                 err = p25TX.writeData(m_buffer + 4U, m_len - 4U);
                             else
                                 err = p25TX.writeData(m_buffer + 3U, m_len - 3U);
@@ -350,8 +376,12 @@ void SerialPort::process()
                 /** Next Generation Digital Narrowband */
                 case CMD_NXDN_DATA:
                     if (m_nxdnEnable) {
-                        if (m_modemState == STATE_IDLE || m_modemState == STATE_NXDN)
-                            err = nxdnTX.writeData(m_buffer + 3U, m_len - 3U);
+                        if (m_modemState == STATE_IDLE || m_modemState == STATE_NXDN) {
+                            if (m_txData != NULL)
+                                err = nxdnTX.commitData(m_len - 3U);
+                            else
+                                err = nxdnTX.writeData(m_buffer + 3U, m_len - 3U);
+                        }
                     }
                     if (err == RSN_OK) {
                         if (m_modemState == STATE_IDLE)
@@ -378,6 +408,7 @@ void SerialPort::process()
                 m_ptr = 0U;
                 m_len = 0U;
                 m_dblFrame = false;
+                m_txData = NULL;
             }
         }
     }
@@ -386,6 +417,7 @@ void SerialPort::process()
         m_ptr = 0U;
         m_len = 0U;
         m_dblFrame = false;
+        m_txData = NULL;
     }
 }
 
@@ -847,11 +879,11 @@ void SerialPort::getStatus()
 {
     io.resetWatchdog();
 
-    uint8_t reply[15U];
+    uint8_t reply[20U];
 
     // send all sorts of interesting internal values
     reply[0U] = DVM_SHORT_FRAME_START;
-    reply[1U] = 12U;
+    reply[1U] = 17U;
     reply[2U] = CMD_GET_STATUS;
 
     reply[3U] = 0x00U;
@@ -916,7 +948,33 @@ void SerialPort::getStatus()
     else
         reply[11U] = 0U;
 
-    writeInt(1U, reply, 12);
+    // P25 Tx FIFO lanes (a lane can hold more frame slots than fit in a byte)
+    if (m_p25Enable) {
+        uint16_t normalDepth = p25TX.getLaneDepth(p25::P25TXLANE_NORMAL);
+        uint16_t priDepth = p25TX.getLaneDepth(p25::P25TXLANE_PRIORITY);
+        uint16_t priSpace = p25TX.getLaneSpace(p25::P25TXLANE_PRIORITY);
+
+        reply[12U] = (normalDepth > 0xFFU) ? 0xFFU : uint8_t(normalDepth);
+        reply[13U] = (priDepth > 0xFFU) ? 0xFFU : uint8_t(priDepth);
+        reply[14U] = (priSpace > 0xFFU) ? 0xFFU : uint8_t(priSpace);
+    }
+    else {
+        reply[12U] = 0U;
+        reply[13U] = 0U;
+        reply[14U] = 0U;
+    }
+
+    // DMR late frames dropped (modulo 256)
+    if (m_dmrEnable && m_duplex) {
+        reply[15U] = (uint8_t)dmrTX.getLateCount1();
+        reply[16U] = (uint8_t)dmrTX.getLateCount2();
+    }
+    else {
+        reply[15U] = 0U;
+        reply[16U] = 0U;
+    }
+
+    writeInt(1U, reply, 17);
 }
 
 /* Write modem DSP version. */
@@ -973,6 +1031,44 @@ uint8_t SerialPort::modemStateCheck(DVM_STATE state)
     return RSN_OK;
 }
 
+/* Helper to reserve the Tx FIFO space the data of the frame being received is written to. */
+
+uint8_t* SerialPort::reserveTxData(uint8_t command, uint8_t flags)
+{
+    // Only frames the command handler would pass to a transmitter are reserved, so nothing else writes
+    // to its FIFO until the frame is complete
+    switch (command) {
+    case CMD_DMR_DATA1:
+        if (m_dmrEnable && !m_dblFrame && m_duplex && (m_modemState == STATE_IDLE || m_modemState == STATE_DMR))
+            return dmrTX.reserveData1(m_len - 3U);
+        break;
+
+    case CMD_DMR_DATA2:
+        if (m_dmrEnable && !m_dblFrame && (m_modemState == STATE_IDLE || m_modemState == STATE_DMR)) {
+            if (m_duplex)
+                return dmrTX.reserveData2(m_len - 3U);
+            else
+                return dmrDMOTX.reserveData(m_len - 3U);
+        }
+        break;
+
+    case CMD_P25_DATA:
+        if (m_p25Enable && (m_modemState == STATE_IDLE || m_modemState == STATE_P25))
+            return p25TX.reserveData(flags, m_dblFrame ? m_len - 4U : m_len - 3U);
+        break;
+
+    case CMD_NXDN_DATA:
+        if (m_nxdnEnable && !m_dblFrame && (m_modemState == STATE_IDLE || m_modemState == STATE_NXDN))
+            return nxdnTX.reserveData(m_len - 3U);
+        break;
+
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
 /* Set modem DSP configuration from serial port data. */
 
 uint8_t SerialPort::setConfig(const uint8_t* data, uint8_t length)
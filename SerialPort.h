@@ -93,6 +93,7 @@ enum DVM_COMMANDS {
     CMD_DMR_CACH_AT_CTRL = 0x1FU,       //! DMR Set CACH AT Control
     CMD_DMR_CLEAR1 = 0x20U,             //! DMR Clear Slot 1 Buffer
     CMD_DMR_CLEAR2 = 0x21U,             //! DMR Clear Slot 2 Buffer
+    CMD_DMR_TX_MAX_AGE = 0x22U,         //! DMR Set Tx Queue Maximum Age
 
     CMD_P25_DATA = 0x31U,               //! Project 25 Data
     CMD_P25_LOST = 0x32U,               //! Project 25 Data Lost
@@ -289,6 +290,7 @@ private:
     uint16_t m_ptr;
     uint16_t m_len;
     bool m_dblFrame;
+    uint8_t* m_txData;
 
     bool m_debug;
 
@@ -317,6 +319,13 @@ private:
      * @returns uint8_t Reason code.
      */
     uint8_t modemStateCheck(DVM_STATE state);
+    /**
+     * @brief Helper to reserve the Tx FIFO space the data of the frame being received is written to.
+     * @param command Frame command.
+     * @param flags Frame flag byte (the first data byte).
+     * @returns uint8_t* Buffer for the data following the flag byte, or NULL if the frame is buffered.
+     */
+    uint8_t* reserveTxData(uint8_t command, uint8_t flags);
     /**
      * @brief Set modem DSP configuration from serial port data.
      * @param[in] data Buffer containing configuration frame.
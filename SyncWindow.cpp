@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+#include "SyncWindow.h"
+#include "Utils.h"
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the SyncWindow class. */
+
+SyncWindow::SyncWindow() :
+    m_minPtr(SYNC_WINDOW_NOPTR),
+    m_maxPtr(SYNC_WINDOW_NOPTR),
+    m_confirmed(false)
+{
+    /* stub */
+}
+
+/* Helper to reset the window. */
+
+void SyncWindow::reset()
+{
+    m_minPtr = SYNC_WINDOW_NOPTR;
+    m_maxPtr = SYNC_WINDOW_NOPTR;
+    m_confirmed = false;
+}
+
+/* Opens the window around the given sync pointer. */
+
+void SyncWindow::open(uint16_t ptr, uint16_t length)
+{
+    m_minPtr = ptr + length - 1U;
+    while (m_minPtr >= length)
+        m_minPtr -= length;
+
+    m_maxPtr = ptr + 1U;
+    while (m_maxPtr >= length)
+        m_maxPtr -= length;
+
+    m_confirmed = false;
+}
+
+/* Sets the window for the next frame from the symbol timing measured over the end of the current frame. */
+
+void SyncWindow::track(const q15_t* buffer, uint16_t length, uint16_t period, uint16_t endPtr, uint16_t syncPtr, q15_t centre, q15_t threshold)
+{
+    track(buffer, length, period, endPtr, syncPtr, length, centre, threshold);
+}
+
+/* Sets the window for the next frame from the symbol timing measured over the end of the current frame, for frames longer than the sample buffer. */
+
+void SyncWindow::track(const q15_t* buffer, uint16_t length, uint16_t period, uint16_t endPtr, uint16_t syncPtr, uint16_t frameLength,
+    q15_t centre, q15_t threshold)
+{
+    // the timing is only followed once a sync has been found in the window, a sync that opened it may
+    // be false (and the timing of its frame meaningless)
+    int8_t adjust = 0;
+    if (m_confirmed) {
+        // measure the timing error over the end of the frame, just before the next sync
+        uint16_t ptr = endPtr + 1U + length - SYNC_TIMING_SYMBOLS * period;
+        if (ptr >= length)
+            ptr -= length;
+
+        adjust = symbolTiming(buffer, length, ptr, SYNC_TIMING_SYMBOLS, period, centre, threshold);
+    }
+
+    m_confirmed = true;
+
+    syncPtr = syncPtr + frameLength + adjust;
+    if (syncPtr >= frameLength)
+        syncPtr -= frameLength;
+
+    // correlate either side of the expected sync position, re-centred on the measured timing
+    m_minPtr = (syncPtr == 0U) ? frameLength - 1U : syncPtr - 1U;
+    m_maxPtr = (syncPtr + 1U >= frameLength) ? 0U : syncPtr + 1U;
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file SyncWindow.h
+ * @ingroup modem_fw
+ * @file SyncWindow.cpp
+ * @ingroup modem_fw
+ */
+#if !defined(__SYNC_WINDOW_H__)
+#define __SYNC_WINDOW_H__
+
+#include "Defines.h"
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint16_t SYNC_WINDOW_NOPTR = 9999U;
+const uint16_t SYNC_TIMING_SYMBOLS = 64U;               // symbols measured for the timing of a frame
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements the window of sample pointers a continuous (P25/NXDN) receiver correlates the sync at
+ *  once locked: the expected sync position and its neighbours. Once a sync has been found in the window,
+ *  it is re-centred between syncs on the symbol timing measured over the end of each frame.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API SyncWindow {
+public:
+    /**
+     * @brief Initializes a new instance of the SyncWindow class.
+     */
+    SyncWindow();
+
+    /**
+     * @brief Helper to reset the window.
+     */
+    void reset();
+
+    /**
+     * @brief Opens the window around the given sync pointer (i.e. the pointer and its neighbours).
+     * @param ptr Sample pointer of the expected sync (less than twice the buffer length).
+     * @param length Length of the sample buffer.
+     */
+    void open(uint16_t ptr, uint16_t length);
+    /**
+     * @brief Sets the window for the next frame from the symbol timing measured over the end of the current frame.
+     * @param buffer Circular sample buffer.
+     * @param length Length of the sample buffer.
+     * @param period Number of samples per symbol.
+     * @param endPtr Sample pointer of the end of the frame.
+     * @param syncPtr Sample pointer of the sync of the frame.
+     * @param centre Symbol centre level.
+     * @param threshold Symbol threshold level.
+     */
+    void track(const q15_t* buffer, uint16_t length, uint16_t period, uint16_t endPtr, uint16_t syncPtr, q15_t centre, q15_t threshold);
+    /**
+     * @brief Sets the window for the next frame from the symbol timing measured over the end of the current frame,
+     *  for frames longer than the sample buffer (the window then holds frame pointers, rather than sample pointers).
+     * @param buffer Circular sample buffer.
+     * @param length Length of the sample buffer.
+     * @param period Number of samples per symbol.
+     * @param endPtr Sample pointer of the end of the frame.
+     * @param syncPtr Frame pointer of the sync of the frame.
+     * @param frameLength Length of the frame.
+     * @param centre Symbol centre level.
+     * @param threshold Symbol threshold level.
+     */
+    void track(const q15_t* buffer, uint16_t length, uint16_t period, uint16_t endPtr, uint16_t syncPtr, uint16_t frameLength,
+        q15_t centre, q15_t threshold);
+
+    /**
+     * @brief Helper to test whether the given sample pointer is in the window.
+     * @param ptr Sample pointer.
+     * @returns bool True, if the sync should be correlated at the sample pointer, otherwise false.
+     */
+    bool contains(uint16_t ptr) const
+    {
+        if (m_minPtr <= m_maxPtr)
+            return ptr >= m_minPtr && ptr <= m_maxPtr;
+        else
+            return ptr >= m_minPtr || ptr <= m_maxPtr;
+    }
+
+    /**
+     * @brief Gets the first sample pointer of the window.
+     * @returns uint16_t First sample pointer of the window.
+     */
+    uint16_t getMinPtr() const { return m_minPtr; }
+    /**
+     * @brief Gets the last sample pointer of the window.
+     * @returns uint16_t Last sample pointer of the window.
+     */
+    uint16_t getMaxPtr() const { return m_maxPtr; }
+
+private:
+    uint16_t m_minPtr;
+    uint16_t m_maxPtr;
+
+    bool m_confirmed;
+};
+
+#endif // __SYNC_WINDOW_H__
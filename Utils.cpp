@@ -20,10 +20,36 @@ const uint8_t BITS_TABLE[] = {
     B6(0), B6(1), B6(1), B6(2)
 };
 
+// dibit of a sliced symbol, indexed by (sample < -threshold, sample < 0, sample < threshold); the first
+// comparison that holds decides the symbol
+const uint8_t SLICE_TABLE[] = { 0x03U, 0x02U, 0x00U, 0x00U, 0x01U, 0x01U, 0x01U, 0x01U };
+
 // ---------------------------------------------------------------------------
 //  Global Functions
 // ---------------------------------------------------------------------------
 
+/* Helper to return how many of the remaining symbols can be read from a circular sample buffer before it wraps. */
+
+static inline uint16_t symbolRun(uint16_t length, uint16_t ptr, uint16_t period, uint16_t remaining)
+{
+    uint16_t run = (length - 1U - ptr) / period + 1U;
+    return (run > remaining) ? remaining : run;
+}
+
+/* Helper to weight a sample by its sliced (4-level) symbol. */
+
+static inline q31_t symbolEnergy(q15_t sample, q15_t threshold)
+{
+    if (sample < -threshold)
+        return -3 * sample;
+    else if (sample < 0)
+        return -sample;
+    else if (sample < threshold)
+        return sample;
+    else
+        return 3 * sample;
+}
+
 /* Returns the count of bits in the passed 8 byte value. */
 
 uint8_t countBits8(uint8_t bits)
@@ -60,3 +86,179 @@ uint8_t countBits64(ulong64_t bits)
     n += BITS_TABLE[p[7U]];
     return n;
 }
+
+/* Returns the symbol timing correction for a run of symbols in a circular sample buffer. */
+
+int8_t symbolTiming(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t centre, q15_t threshold)
+{
+    // early/late gate; slice the symbols a sample early, on time and a sample late, and weight each
+    // sample by its symbol, the timing with the most energy samples the symbols closest to their peaks
+    q31_t energy[3U] = { 0, 0, 0 };
+    ptr = (ptr == 0U) ? length - 1U : ptr - 1U;
+
+    uint16_t i = 0U;
+    while (i < count) {
+        // the three samples of each symbol of the run are contiguous
+        uint16_t run = (ptr + 2U < length) ? symbolRun(length - 2U, ptr, period, count - i) : 0U;
+        if (run > 0U) {
+            const q15_t* p = buffer + ptr;
+            for (uint16_t j = 0U; j < run; j++, p += period) {
+                energy[0U] += symbolEnergy(p[0U] - centre, threshold);
+                energy[1U] += symbolEnergy(p[1U] - centre, threshold);
+                energy[2U] += symbolEnergy(p[2U] - centre, threshold);
+            }
+        }
+        else {
+            // the symbol straddles the end of the buffer
+            uint16_t p = ptr;
+            for (uint8_t j = 0U; j < 3U; j++) {
+                energy[j] += symbolEnergy(buffer[p] - centre, threshold);
+
+                p++;
+                if (p >= length)
+                    p = 0U;
+            }
+
+            run = 1U;
+        }
+
+        i += run;
+        ptr += run * period;
+        if (ptr >= length)
+            ptr -= length;
+    }
+
+    if (energy[0U] > energy[1U] && energy[0U] >= energy[2U])
+        return -1;
+    if (energy[2U] > energy[1U])
+        return 1;
+
+    return 0;
+}
+
+/* Correlates a run of symbols in a circular sample buffer against a sync pattern. */
+
+q31_t correlateSymbols(const q15_t* buffer, uint16_t length, uint16_t ptr, const int8_t* values, uint8_t count, uint16_t period,
+    q15_t& min, q15_t& max)
+{
+    q31_t corr = 0;
+    min = 16000;
+    max = -16000;
+
+    uint8_t i = 0U;
+    while (i < count) {
+        uint16_t run = symbolRun(length, ptr, period, count - i);
+
+        const q15_t* p = buffer + ptr;
+        for (uint16_t j = 0U; j < run; j++, i++, p += period) {
+            q15_t val = *p;
+
+            if (val > max)
+                max = val;
+            if (val < min)
+                min = val;
+
+            corr -= val * values[i];
+        }
+
+        ptr += run * period;
+        if (ptr >= length)
+            ptr -= length;
+    }
+
+    return corr;
+}
+
+/* Slices a run of symbols in a circular sample buffer into packed dibits. */
+
+void sliceSymbols(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t centre, q15_t threshold,
+    uint8_t* out, uint16_t offset)
+{
+    // the dibits are gathered into whole bytes, starting with the bits already in the first byte
+    uint8_t* p = out + (offset >> 3);
+    uint8_t bits = offset & 7U;
+    uint32_t acc = (bits > 0U) ? (*p >> (8U - bits)) : 0U;
+
+    uint16_t i = 0U;
+    while (i < count) {
+        uint16_t run = symbolRun(length, ptr, period, count - i);
+
+        const q15_t* s = buffer + ptr;
+        uint16_t j = 0U;
+
+        // four symbols fill a byte
+        for (; j + 4U <= run; j += 4U, s += 4U * period) {
+            uint8_t byte = 0U;
+            for (uint8_t k = 0U; k < 4U; k++) {
+                q15_t sample = s[k * period] - centre;
+                uint8_t index = ((sample < -threshold) << 2) | ((sample < 0) << 1) | (sample < threshold);
+                byte = (byte << 2) | SLICE_TABLE[index];
+            }
+
+            acc = (acc << 8) | byte;
+            *p++ = uint8_t(acc >> bits);
+        }
+
+        for (; j < run; j++, s += period) {
+            q15_t sample = *s - centre;
+            uint8_t index = ((sample < -threshold) << 2) | ((sample < 0) << 1) | (sample < threshold);
+
+            acc = (acc << 2) | SLICE_TABLE[index];
+            bits += 2U;
+            if (bits >= 8U) {
+                bits -= 8U;
+                *p++ = uint8_t(acc >> bits);
+            }
+        }
+
+        i += run;
+        ptr += run * period;
+        if (ptr >= length)
+            ptr -= length;
+    }
+
+    // keep the bits after the run in the last byte
+    if (bits > 0U)
+        *p = uint8_t(acc << (8U - bits)) | (*p & (0xFFU >> bits));
+}
+
+/* Finds the positive and negative symbol levels of a run of symbols in a circular sample buffer. */
+
+void symbolLevels(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t& posThresh, q15_t& negThresh)
+{
+    q15_t maxPos = -16000;
+    q15_t minPos = 16000;
+    q15_t maxNeg = 16000;
+    q15_t minNeg = -16000;
+
+    uint16_t i = 0U;
+    while (i < count) {
+        uint16_t run = symbolRun(length, ptr, period, count - i);
+
+        const q15_t* p = buffer + ptr;
+        for (uint16_t j = 0U; j < run; j++, p += period) {
+            q15_t sample = *p;
+
+            if (sample > 0) {
+                if (sample > maxPos)
+                    maxPos = sample;
+                if (sample < minPos)
+                    minPos = sample;
+            }
+            else {
+                if (sample < maxNeg)
+                    maxNeg = sample;
+                if (sample > minNeg)
+                    minNeg = sample;
+            }
+        }
+
+        i += run;
+        ptr += run * period;
+        if (ptr >= length)
+            ptr -= length;
+    }
+
+    posThresh = (maxPos + minPos) >> 1;
+    negThresh = (maxNeg + minNeg) >> 1;
+}
@@ -41,4 +41,61 @@ DSP_FW_API uint8_t countBits32(uint32_t bits);
  */
 DSP_FW_API uint8_t countBits64(ulong64_t bits);
 
+/**
+ * @brief Returns the symbol timing correction for a run of symbols in a circular sample buffer, from
+ *  an early/late gate on the sliced (4-level) symbols.
+ * @param buffer Circular sample buffer.
+ * @param length Length of the sample buffer.
+ * @param ptr Sample pointer of the first symbol.
+ * @param count Number of symbols.
+ * @param period Number of samples per symbol.
+ * @param centre Symbol centre level.
+ * @param threshold Symbol threshold level.
+ * @returns int8_t -1 if the symbols are better sampled a sample earlier, 1 if a sample later, otherwise 0.
+ */
+DSP_FW_API int8_t symbolTiming(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t centre, q15_t threshold);
+/**
+ * @brief Correlates a run of symbols in a circular sample buffer against a sync pattern, and finds
+ *  the sample range of the run. A positive symbol is a negative sample, so the sync pattern gives
+ *  a positive correlation, and its complement (the same magnitude) a negative one.
+ * @param buffer Circular sample buffer.
+ * @param length Length of the sample buffer.
+ * @param ptr Sample pointer of the first symbol.
+ * @param values Sync pattern symbol values.
+ * @param count Number of symbols.
+ * @param period Number of samples per symbol.
+ * @param[out] min Lowest sample of the run.
+ * @param[out] max Highest sample of the run.
+ * @returns q31_t Correlation of the samples with the sync pattern.
+ */
+DSP_FW_API q31_t correlateSymbols(const q15_t* buffer, uint16_t length, uint16_t ptr, const int8_t* values, uint8_t count, uint16_t period,
+    q15_t& min, q15_t& max);
+/**
+ * @brief Slices a run of symbols in a circular sample buffer into packed dibits (4-level). The bits of
+ *  the output buffer before and after the dibits are unchanged.
+ * @param buffer Circular sample buffer.
+ * @param length Length of the sample buffer.
+ * @param ptr Sample pointer of the first symbol.
+ * @param count Number of symbols.
+ * @param period Number of samples per symbol.
+ * @param centre Symbol centre level.
+ * @param threshold Symbol threshold level.
+ * @param[out] out Output buffer.
+ * @param offset Bit offset of the first dibit in the output buffer.
+ */
+DSP_FW_API void sliceSymbols(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t centre, q15_t threshold,
+    uint8_t* out, uint16_t offset);
+/**
+ * @brief Finds the positive and negative symbol levels of a run of symbols in a circular sample buffer,
+ *  each the midpoint of the highest and lowest sample of that polarity.
+ * @param buffer Circular sample buffer.
+ * @param length Length of the sample buffer.
+ * @param ptr Sample pointer of the first symbol.
+ * @param count Number of symbols.
+ * @param period Number of samples per symbol.
+ * @param[out] posThresh Positive symbol level.
+ * @param[out] negThresh Negative symbol level.
+ */
+DSP_FW_API void symbolLevels(const q15_t* buffer, uint16_t length, uint16_t ptr, uint16_t count, uint16_t period, q15_t& posThresh, q15_t& negThresh);
+
 #endif // __UTILS_H__
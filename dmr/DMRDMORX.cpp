@@ -37,9 +37,9 @@ const uint8_t CONTROL_DATA = 0x40U;
 
 /* Initializes a new instance of the DMRDMORX class. */
 
-DMRDMORX::DMRDMORX() :
+DMRDMORX::DMRDMORX(q15_t* buffer) :
     m_bitBuffer(),
-    m_buffer(),
+    m_buffer(buffer),
     m_bitPtr(0U),
     m_dataPtr(0U),
     m_syncPtr(0U),
@@ -54,10 +54,11 @@ DMRDMORX::DMRDMORX() :
     m_colorCode(0U),
     m_state(DMORXS_NONE),
     m_n(0U),
-    m_type(0U),
-    m_rssi()
+    m_type(0U)
 {
-    /* stub */
+#if defined(SEND_RSSI_DATA)
+    ::memset(m_rssi, 0x00U, sizeof(m_rssi));
+#endif
 }
 
 /* Helper to reset data values to defaults. */
@@ -75,12 +76,20 @@ void DMRDMORX::reset()
 
 /* Sample DMR values from the air interface. */
 
-void DMRDMORX::samples(const q15_t* samples, const uint16_t* rssi, uint8_t length)
+void DMRDMORX::samples(const q15_t* samples, const uint16_t* rssi, uint16_t length)
 {
     bool dcd = false;
 
-    for (uint8_t i = 0U; i < length; i++)
+#if !defined(SEND_RSSI_DATA)
+    (void)rssi;
+#endif
+
+    for (uint16_t i = 0U; i < length; i++)
+#if defined(SEND_RSSI_DATA)
         dcd = processSample(samples[i], rssi[i]);
+#else
+        dcd = processSample(samples[i], 0U);
+#endif
 
     io.setDecode(dcd);
 }
@@ -101,7 +110,15 @@ void DMRDMORX::setColorCode(uint8_t colorCode)
 bool DMRDMORX::processSample(q15_t sample, uint16_t rssi)
 {
     m_buffer[m_dataPtr] = sample;
-    m_rssi[m_dataPtr] = rssi;
+#if defined(SEND_RSSI_DATA)
+    // the RSSI is kept per symbol period (the sum of its samples), rather than per sample
+    if ((m_dataPtr % DMR_RADIO_SYMBOL_LENGTH) == 0U)
+        m_rssi[m_dataPtr / DMR_RADIO_SYMBOL_LENGTH] = rssi;
+    else
+        m_rssi[m_dataPtr / DMR_RADIO_SYMBOL_LENGTH] += rssi;
+#else
+    (void)rssi;
+#endif
 
     m_bitBuffer[m_bitPtr] <<= 1;
     if (sample < 0)
@@ -267,43 +284,12 @@ void DMRDMORX::correlateSync(bool first)
         if (ptr >= DMO_BUFFER_LENGTH_SAMPLES)
             ptr -= DMO_BUFFER_LENGTH_SAMPLES;
 
-        q31_t corr = 0;
-        q15_t min = 16000;
-        q15_t max = -16000;
-
-        for (uint8_t i = 0U; i < DMR_SYNC_LENGTH_SYMBOLS; i++) {
-            q15_t val = m_buffer[ptr];
-
-            if (val > max)
-                max = val;
-            if (val < min)
-                min = val;
-
-            int8_t corrVal;
-            if (data)
-                corrVal = DMR_MS_DATA_SYNC_SYMBOLS_VALUES[i];
-            else
-                corrVal = DMR_MS_VOICE_SYNC_SYMBOLS_VALUES[i];
-
-            switch (corrVal) {
-            case +3:
-                corr -= (val + val + val);
-                break;
-            case +1:
-                corr -= val;
-                break;
-            case -1:
-                corr += val;
-                break;
-            default:  // -3
-                corr += (val + val + val);
-                break;
-            }
-
-            ptr += DMR_RADIO_SYMBOL_LENGTH;
-            if (ptr >= DMO_BUFFER_LENGTH_SAMPLES)
-                ptr -= DMO_BUFFER_LENGTH_SAMPLES;
-        }
+        // one pass correlates both patterns, the voice sync correlation is the negated data sync correlation
+        q15_t min, max;
+        q31_t corr = correlateSymbols(m_buffer, DMO_BUFFER_LENGTH_SAMPLES, ptr, DMR_MS_DATA_SYNC_SYMBOLS_VALUES, DMR_SYNC_LENGTH_SYMBOLS,
+            DMR_RADIO_SYMBOL_LENGTH, min, max);
+        if (!data)
+            corr = -corr;
 
         if (corr > m_maxCorr) {
             q15_t centre = (max + min) >> 1;
@@ -408,38 +394,7 @@ void DMRDMORX::correlateSync(bool first)
 
 void DMRDMORX::samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
 {
-    for (uint8_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start] - centre;
-
-        if (sample < -threshold) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-        else if (sample < 0) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else if (sample < threshold) {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-
-        start += DMR_RADIO_SYMBOL_LENGTH;
-        if (start >= DMO_BUFFER_LENGTH_SAMPLES)
-            start -= DMO_BUFFER_LENGTH_SAMPLES;
-    }
+    sliceSymbols(m_buffer, DMO_BUFFER_LENGTH_SAMPLES, start, count, DMR_RADIO_SYMBOL_LENGTH, centre, threshold, buffer, offset);
 }
 
 /* */
@@ -448,15 +403,17 @@ void DMRDMORX::writeRSSIData(uint8_t* frame)
 {
 #if defined(SEND_RSSI_DATA)
     // Calculate RSSI average over a burst period. We don't take into account 2.5 ms at the beginning and 2.5 ms at the end
-    uint16_t start = m_startPtr + DMR_SYNC_LENGTH_SAMPLES / 2U;
+    uint16_t start = (m_startPtr + DMR_SYNC_LENGTH_SAMPLES / 2U) / DMR_RADIO_SYMBOL_LENGTH;
+    if (start >= DMO_RSSI_LENGTH)
+        start -= DMO_RSSI_LENGTH;
 
     uint32_t accum = 0U;
-    for (uint16_t i = 0U; i < (DMR_FRAME_LENGTH_SAMPLES - DMR_SYNC_LENGTH_SAMPLES); i++) {
+    for (uint16_t i = 0U; i < (DMR_FRAME_LENGTH_SYMBOLS - DMR_SYNC_LENGTH_SYMBOLS); i++) {
         accum += m_rssi[start];
 
         start++;
-        if (start >= DMO_BUFFER_LENGTH_SAMPLES)
-            start -= DMO_BUFFER_LENGTH_SAMPLES;
+        if (start >= DMO_RSSI_LENGTH)
+            start -= DMO_RSSI_LENGTH;
     }
 
     uint16_t avg = accum / (DMR_FRAME_LENGTH_SAMPLES - DMR_SYNC_LENGTH_SAMPLES);
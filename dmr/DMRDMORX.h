@@ -30,6 +30,7 @@ namespace dmr
     // ---------------------------------------------------------------------------
 
     const uint16_t DMO_BUFFER_LENGTH_SAMPLES = 1440U;   // 60ms at 24 kHz
+    const uint16_t DMO_RSSI_LENGTH = DMO_BUFFER_LENGTH_SAMPLES / DMR_RADIO_SYMBOL_LENGTH;
 
     /**
      * @brief DMR DMO Receiver State
@@ -53,8 +54,10 @@ namespace dmr
     public:
         /**
          * @brief Initializes a new instance of the DMRDMORX class.
+         * @param buffer Sample history buffer, DMO_BUFFER_LENGTH_SAMPLES samples long (shared with the
+         *  idle receiver, only one of them runs at a time).
          */
-        DMRDMORX();
+        DMRDMORX(q15_t* buffer);
 
         /**
          * @brief Helper to reset data values to defaults.
@@ -67,7 +70,7 @@ namespace dmr
          * @param[in] rssi
          * @param length 
          */
-        void samples(const q15_t* samples, const uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, const uint16_t* rssi, uint16_t length);
 
         /**
          * @brief Sets the DMR color code.
@@ -77,7 +80,7 @@ namespace dmr
 
     private:
         uint32_t m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-        q15_t m_buffer[DMO_BUFFER_LENGTH_SAMPLES];
+        q15_t* m_buffer;
 
         uint16_t m_bitPtr;
         uint16_t m_dataPtr;
@@ -101,7 +104,9 @@ namespace dmr
 
         uint8_t m_type;
 
-        uint16_t m_rssi[DMO_BUFFER_LENGTH_SAMPLES];
+#if defined(SEND_RSSI_DATA)
+        uint16_t m_rssi[DMO_RSSI_LENGTH];
+#endif
 
         /**
          * @brief Helper to perform sample processing.
@@ -29,8 +29,6 @@ const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
 
 const q15_t DMR_LEVELA = 1362;
 const q15_t DMR_LEVELB = 454;
-const q15_t DMR_LEVELC = -454;
-const q15_t DMR_LEVELD = -1362;
 
 // PR FILL pattern
 const uint8_t PR_FILL[] =
@@ -46,22 +44,25 @@ const uint8_t PR_FILL[] =
 /* Initializes a new instance of the DMRDMOTX class. */
 
 DMRDMOTX::DMRDMOTX() :
-    m_fifo(DMR_TX_BUFFER_LEN),
-    m_modFilter(),
-    m_modState(),
+    m_fifo(DMR_FRAME_LENGTH_BYTES, DMR_FRAME_LENGTH_BYTES, DMR_TX_BUFFER_LEN),
+    m_modulator(),
+    m_waveCache(),
+    m_modTable(),
+    m_cacheKeys(),
+    m_cacheSamples(),
     m_poBuffer(),
+    m_poData(m_poBuffer),
+    m_poFifo(false),
     m_poLen(0U),
     m_poPtr(0U),
+    m_poCache(false),
     m_preambleCnt(DMRDMO_FIXED_DELAY),
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U)
 {
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-    m_modFilter.L = DMR_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RRC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
+    m_modulator.init(RRC_0_2_FILTER, RRC_0_2_FILTER_PHASE_LEN, DMR_RADIO_SYMBOL_LENGTH, m_modTable);
+    m_modulator.setLevels(DMR_LEVELA, DMR_LEVELB);
+    m_waveCache.init(&m_modulator, NULL, 0U, FSK_CACHE_ENTRIES, m_cacheKeys, m_cacheSamples, NULL);
 }
 
 /* Process local buffer and transmit on the air interface. */
@@ -73,18 +74,20 @@ void DMRDMOTX::process()
             for (uint16_t i = 0U; i < m_preambleCnt; i++)
                 m_poBuffer[i] = DMR_START_SYNC;
 
+            m_poData = m_poBuffer;
+            m_poFifo = false;
             m_poLen = m_preambleCnt;
         }
         else {
-            for (unsigned int i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++)
-                m_poBuffer[i] = m_fifo.get();
-
-            for (unsigned int i = 0U; i < 39U; i++)
-                m_poBuffer[i + DMR_FRAME_LENGTH_BYTES] = PR_FILL[i];
-
+            // the frame is transmitted straight from its FIFO slot
+            uint16_t length = 0U;
+            m_poData = m_fifo.get(length);
+            m_poFifo = true;
             m_poLen = 72U;
         }
 
+        // the preamble and the calibration frames are static patterns
+        m_poCache = !m_tx || (FSK_CACHE_FRAMES && m_modemState == STATE_DMR_DMO_CAL_1K);
         m_poPtr = 0U;
     }
 
@@ -96,13 +99,21 @@ void DMRDMOTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * DMR_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr++];
+            // the PR FILL following a frame read from the FIFO comes straight from its table
+            uint8_t c = (m_poFifo && m_poPtr >= DMR_FRAME_LENGTH_BYTES) ? PR_FILL[m_poPtr - DMR_FRAME_LENGTH_BYTES] : m_poData[m_poPtr];
+            m_poPtr++;
 
-            writeByte(c);
+            // the PR FILL after each frame is a static pattern too
+            writeByte(c, m_poCache || (FSK_CACHE_FRAMES && m_poPtr > DMR_FRAME_LENGTH_BYTES));
 
             space -= 4U * DMR_RADIO_SYMBOL_LENGTH;
 
             if (m_poPtr >= m_poLen) {
+                if (m_poFifo) {
+                    m_fifo.release();
+                    m_poFifo = false;
+                }
+
                 m_poPtr = 0U;
                 m_poLen = 0U;
                 return;
@@ -114,18 +125,35 @@ void DMRDMOTX::process()
 /* Write data to the local buffer. */
 
 uint8_t DMRDMOTX::writeData(const uint8_t* data, uint8_t length)
+{
+    uint8_t* buffer = reserveData(length);
+    if (buffer != NULL)
+        ::memcpy(buffer, data + 1U, DMR_FRAME_LENGTH_BYTES);
+
+    return commitData(length);
+}
+
+/* Reserves the local buffer space for data, which the caller fills in place. */
+
+uint8_t* DMRDMOTX::reserveData(uint8_t length)
+{
+    if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
+        return NULL;
+
+    return m_fifo.reserve(DMR_FRAME_LENGTH_BYTES);
+}
+
+/* Writes the data filled in place since reserveData() to the local buffer. */
+
+uint8_t DMRDMOTX::commitData(uint8_t length)
 {
     if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
         return RSN_ILLEGAL_LENGTH;
 
-    uint16_t space = m_fifo.getSpace();
-    DEBUG3("DMRDMOTX::writeData() dataLength/fifoLength", length, space);
-    if (space < DMR_FRAME_LENGTH_BYTES)
+    DEBUG3("DMRDMOTX::commitData() dataLength/fifoSpace", length, m_fifo.getSpace());
+    if (!m_fifo.commit(DMR_FRAME_LENGTH_BYTES))
         return RSN_RINGBUFF_FULL;
 
-    for (uint8_t i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++)
-        m_fifo.put(data[i + 1U]);
-
     return RSN_OK;
 }
 
@@ -159,21 +187,31 @@ void DMRDMOTX::setSymbolLvlAdj(int8_t level3Adj, int8_t level1Adj)
         m_symLevel1Adj = 0;
     if (m_symLevel1Adj < -128)
         m_symLevel1Adj = 0;
+
+    m_modulator.setLevels(DMR_LEVELA + m_symLevel3Adj, DMR_LEVELB + m_symLevel1Adj);
+    m_waveCache.clear();
 }
 
 /* Helper to resize the FIFO buffer. */
 
 void DMRDMOTX::resizeBuffer(uint16_t size)
 {
-    m_fifo.reset();
+    // the frame being transmitted is read from the FIFO in place, so it has to outlive it
+    if (m_poFifo) {
+        ::memcpy(m_poBuffer, m_poData, DMR_FRAME_LENGTH_BYTES);
+        ::memcpy(m_poBuffer + DMR_FRAME_LENGTH_BYTES, PR_FILL, 39U);
+        m_poData = m_poBuffer;
+        m_poFifo = false;
+    }
+
     m_fifo.reinitialize(size);
 }
 
-/* Helper to get how much space the ring buffer has for samples. */
+/* Helper to get how many frames the ring buffer has space for. */
 
 uint8_t DMRDMOTX::getSpace() const
 {
-    return m_fifo.getSpace() / (DMR_FRAME_LENGTH_BYTES + 2U);
+    return m_fifo.getSpace();
 }
 
 // ---------------------------------------------------------------------------
@@ -182,31 +220,25 @@ uint8_t DMRDMOTX::getSpace() const
 
 /* Helper to write a raw byte to the DAC. */
 
-void DMRDMOTX::writeByte(uint8_t c)
+void DMRDMOTX::writeByte(uint8_t c, bool cache)
 {
-    q15_t inBuffer[4U];
     q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
 
-    const uint8_t MASK = 0xC0U;
-
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (DMR_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (DMR_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (DMR_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (DMR_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    if (cache) {
+        const q15_t* samples = m_waveCache.find(c, false);
+        if (samples != NULL) {
+            io.write(STATE_DMR, samples, DMR_RADIO_SYMBOL_LENGTH * 4U);
+            return;
         }
     }
+    else {
+        m_waveCache.skip(c, false);
+    }
+
+    m_modulator.modulate(c, outBuffer);
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+    if (cache)
+        m_waveCache.store(outBuffer, NULL);
 
     io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U);
 }
@@ -215,10 +247,17 @@ void DMRDMOTX::writeByte(uint8_t c)
 
 void DMRDMOTX::writeSilence()
 {
-    q15_t inBuffer[4U] = { 0x00U, 0x00U, 0x00U, 0x00U };
     q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+    const q15_t* samples = m_waveCache.find(0U, true);
+    if (samples != NULL) {
+        io.write(STATE_DMR, samples, DMR_RADIO_SYMBOL_LENGTH * 4U);
+        return;
+    }
+
+    m_modulator.silence(outBuffer);
+
+    m_waveCache.store(outBuffer, NULL);
 
     io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U);
 }
@@ -20,7 +20,8 @@
 
 #include "Defines.h"
 #include "dmr/DMRDefines.h"
-#include "SerialBuffer.h"
+#include "FSKModulator.h"
+#include "FrameBuffer.h"
 
 namespace dmr
 {
@@ -58,6 +59,19 @@ namespace dmr
          * @returns uint8_t Reason code.
          */
         uint8_t writeData(const uint8_t* data, uint8_t length);
+        /**
+         * @brief Reserves the local buffer space for data, which the caller fills in place and then
+         *  passes to commitData().
+         * @param length Length of data (as for writeData(), including the leading flag byte).
+         * @returns uint8_t* Buffer for the data following the flag byte, or NULL if there is no space.
+         */
+        uint8_t* reserveData(uint8_t length);
+        /**
+         * @brief Writes the data filled in place since reserveData() to the local buffer.
+         * @param length Length of data (as for writeData(), including the leading flag byte).
+         * @returns uint8_t Reason code.
+         */
+        uint8_t commitData(uint8_t length);
 
         /**
          * @brief Sets the FDMA preamble count.
@@ -78,21 +92,28 @@ namespace dmr
         void resizeBuffer(uint16_t size);
 
         /**
-         * @brief Helper to get how much space the ring buffer has for samples.
-         * @returns uint8_t Amount of space in ring buffer for samples. 
+         * @brief Helper to get how many frames the ring buffer has space for.
+         * @returns uint8_t Number of free frame slots.
          */
         uint8_t getSpace() const;
 
     private:
-        SerialBuffer m_fifo;
+        FrameBuffer m_fifo;
+
+        FSKModulator m_modulator;
+        FSKWaveCache m_waveCache;
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
+        q31_t m_modTable[DMR_RADIO_SYMBOL_LENGTH * FSK_MOD_GROUPS_MAX * FSK_MOD_TABLE_LEN];
 
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+        uint64_t m_cacheKeys[FSK_CACHE_ENTRIES];
+        q15_t m_cacheSamples[FSK_CACHE_ENTRIES * DMR_RADIO_SYMBOL_LENGTH * 4U];
 
         uint8_t m_poBuffer[1200U];
+        const uint8_t* m_poData;
+        bool m_poFifo;
         uint16_t m_poLen;
         uint16_t m_poPtr;
+        bool m_poCache;
 
         uint32_t m_preambleCnt;
 
@@ -102,8 +123,9 @@ namespace dmr
         /**
          * @brief Helper to write a raw byte to the DAC.
          * @param c Byte.
+         * @param cache Flag indicating the byte is part of a static pattern, whose samples are cached.
          */
-        void writeByte(uint8_t c);
+        void writeByte(uint8_t c, bool cache);
         /**
          * @brief 
          */
@@ -38,9 +38,9 @@ const uint8_t CONTROL_DATA = 0x40U;
 
 /* Initializes a new instance of the DMRIdleRX class. */
 
-DMRIdleRX::DMRIdleRX() :
+DMRIdleRX::DMRIdleRX(q15_t* buffer) :
     m_bitBuffer(),
-    m_buffer(),
+    m_buffer(buffer),
     m_bitPtr(0U),
     m_dataPtr(0U),
     m_endPtr(NOENDPTR),
@@ -66,9 +66,9 @@ void DMRIdleRX::reset()
 
 /* Sample DMR values from the air interface. */
 
-void DMRIdleRX::samples(const q15_t* samples, uint8_t length)
+void DMRIdleRX::samples(const q15_t* samples, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++)
+    for (uint16_t i = 0U; i < length; i++)
         processSample(samples[i]);
 }
 
@@ -98,37 +98,9 @@ void DMRIdleRX::processSample(q15_t sample)
         if (ptr >= DMR_FRAME_LENGTH_SAMPLES)
             ptr -= DMR_FRAME_LENGTH_SAMPLES;
 
-        q31_t corr = 0;
-        q15_t max = -16000;
-        q15_t min = 16000;
-
-        for (uint8_t i = 0U; i < DMR_SYNC_LENGTH_SYMBOLS; i++) {
-            q15_t val = m_buffer[ptr];
-
-            if (val > max)
-                max = val;
-            if (val < min)
-                min = val;
-
-            switch (DMR_MS_DATA_SYNC_SYMBOLS_VALUES[i]) {
-            case +3:
-                corr -= (val + val + val);
-                break;
-            case +1:
-                corr -= val;
-                break;
-            case -1:
-                corr += val;
-                break;
-            default:  // -3
-                corr += (val + val + val);
-                break;
-            }
-
-            ptr += DMR_RADIO_SYMBOL_LENGTH;
-            if (ptr >= DMR_FRAME_LENGTH_SAMPLES)
-                ptr -= DMR_FRAME_LENGTH_SAMPLES;
-        }
+        q15_t min, max;
+        q31_t corr = correlateSymbols(m_buffer, DMR_FRAME_LENGTH_SAMPLES, ptr, DMR_MS_DATA_SYNC_SYMBOLS_VALUES, DMR_SYNC_LENGTH_SYMBOLS,
+            DMR_RADIO_SYMBOL_LENGTH, min, max);
 
         if (corr > m_maxCorr) {
             q15_t centre = (max + min) >> 1;
@@ -196,36 +168,5 @@ void DMRIdleRX::processSample(q15_t sample)
 
 void DMRIdleRX::samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
 {
-    for (uint8_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start] - centre;
-
-        if (sample < -threshold) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-        else if (sample < 0) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else if (sample < threshold) {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-
-        start += DMR_RADIO_SYMBOL_LENGTH;
-        if (start >= DMR_FRAME_LENGTH_SAMPLES)
-            start -= DMR_FRAME_LENGTH_SAMPLES;
-    }
+    sliceSymbols(m_buffer, DMR_FRAME_LENGTH_SAMPLES, start, count, DMR_RADIO_SYMBOL_LENGTH, centre, threshold, buffer, offset);
 }
@@ -37,8 +37,10 @@ namespace dmr
     public:
         /**
          * @brief Initializes a new instance of the DMRIdleRX class.
+         * @param buffer Sample history buffer, at least DMR_FRAME_LENGTH_SAMPLES samples long (shared with
+         *  the DMO receiver, only one of them runs at a time).
          */
-        DMRIdleRX();
+        DMRIdleRX(q15_t* buffer);
 
         /**
          * @brief Helper to reset data values to defaults.
@@ -50,7 +52,7 @@ namespace dmr
          * @param[in] samples 
          * @param length 
          */
-        void samples(const q15_t* samples, uint8_t length);
+        void samples(const q15_t* samples, uint16_t length);
 
         /**
          * @brief Sets the DMR color code.
@@ -60,7 +62,7 @@ namespace dmr
 
     private:
         uint32_t m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-        q15_t m_buffer[DMR_FRAME_LENGTH_SAMPLES];
+        q15_t* m_buffer;
         uint16_t m_bitPtr;
         uint16_t m_dataPtr;
         uint16_t m_endPtr;
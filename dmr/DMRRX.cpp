@@ -35,7 +35,7 @@ void DMRRX::reset()
 
 /* Sample DMR values from the air interface. */
 
-void DMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length)
+void DMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length)
 {
     bool dcd1 = false;
     bool dcd2 = false;
@@ -52,8 +52,14 @@ void DMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* c
             break;
         }
 
-        dcd1 = m_slot1RX.processSample(samples[i], rssi[i]);
-        dcd2 = m_slot2RX.processSample(samples[i], rssi[i]);
+#if defined(SEND_RSSI_DATA)
+        uint16_t ss = rssi[i];
+#else
+        (void)rssi;
+        uint16_t ss = 0U;
+#endif
+        dcd1 = m_slot1RX.processSample(samples[i], ss);
+        dcd2 = m_slot2RX.processSample(samples[i], ss);
     }
 
     io.setDecode(dcd1 || dcd2);
@@ -48,7 +48,7 @@ namespace dmr
          * @param[in] control 
          * @param length 
          */
-        void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length);
+        void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length);
 
         /**
          * @brief Sets the DMR color code.
@@ -60,10 +60,11 @@ DMRSlotRX::DMRSlotRX(bool slot) :
     m_delay(0U),
     m_state(DMRRXS_NONE),
     m_n(0U),
-    m_type(0U),
-    m_rssi()
+    m_type(0U)
 {
-    /* stub */
+#if defined(SEND_RSSI_DATA)
+    ::memset(m_rssi, 0x00U, sizeof(m_rssi));
+#endif
 }
 
 /* Helper to set data values for start of Rx. */
@@ -102,11 +103,19 @@ bool DMRSlotRX::processSample(q15_t sample, uint16_t rssi)
         return m_state != DMRRXS_NONE;
 
     // Ensure that the buffer doesn't overflow
-    if (m_dataPtr > m_endPtr || m_dataPtr >= 900U)
+    if (m_dataPtr > m_endPtr || m_dataPtr >= DMR_SLOT_BUFFER_LENGTH_SAMPLES)
         return m_state != DMRRXS_NONE;
 
     m_buffer[m_dataPtr] = sample;
-    m_rssi[m_dataPtr] = rssi;
+#if defined(SEND_RSSI_DATA)
+    // the RSSI is kept per symbol period (the sum of its samples), rather than per sample
+    if ((m_dataPtr % DMR_RADIO_SYMBOL_LENGTH) == 0U)
+        m_rssi[m_dataPtr / DMR_RADIO_SYMBOL_LENGTH] = rssi;
+    else
+        m_rssi[m_dataPtr / DMR_RADIO_SYMBOL_LENGTH] += rssi;
+#else
+    (void)rssi;
+#endif
 
     m_bitBuffer[m_bitPtr] <<= 1;
     if (sample < 0)
@@ -271,41 +280,12 @@ void DMRSlotRX::correlateSync(bool first)
     if (data || voice) {
         uint16_t ptr = m_dataPtr - DMR_SYNC_LENGTH_SAMPLES + DMR_RADIO_SYMBOL_LENGTH;
 
-        q31_t corr = 0;
-        q15_t min = 16000;
-        q15_t max = -16000;
-
-        for (uint8_t i = 0U; i < DMR_SYNC_LENGTH_SYMBOLS; i++) {
-            q15_t val = m_buffer[ptr];
-
-            if (val > max)
-                max = val;
-            if (val < min)
-                min = val;
-
-            int8_t corrVal;
-            if (data)
-                corrVal = DMR_MS_DATA_SYNC_SYMBOLS_VALUES[i];
-            else
-                corrVal = DMR_MS_VOICE_SYNC_SYMBOLS_VALUES[i];
-
-            switch (corrVal) {
-            case +3:
-                corr -= (val + val + val);
-                break;
-            case +1:
-                corr -= val;
-                break;
-            case -1:
-                corr += val;
-                break;
-            default:  // -3
-                corr += (val + val + val);
-                break;
-            }
-
-            ptr += DMR_RADIO_SYMBOL_LENGTH;
-        }
+        // one pass correlates both patterns, the voice sync correlation is the negated data sync correlation
+        q15_t min, max;
+        q31_t corr = correlateSymbols(m_buffer, DMR_SLOT_BUFFER_LENGTH_SAMPLES, ptr, DMR_MS_DATA_SYNC_SYMBOLS_VALUES, DMR_SYNC_LENGTH_SYMBOLS,
+            DMR_RADIO_SYMBOL_LENGTH, min, max);
+        if (!data)
+            corr = -corr;
 
         if (corr > m_maxCorr) {
             q15_t centre = (max + min) >> 1;
@@ -395,34 +375,7 @@ void DMRSlotRX::correlateSync(bool first)
 
 void DMRSlotRX::samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
 {
-    for (uint8_t i = 0U; i < count; i++, start += DMR_RADIO_SYMBOL_LENGTH) {
-        q15_t sample = m_buffer[start] - centre;
-
-        if (sample < -threshold) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-        else if (sample < 0) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else if (sample < threshold) {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-    }
+    sliceSymbols(m_buffer, DMR_SLOT_BUFFER_LENGTH_SAMPLES, start, count, DMR_RADIO_SYMBOL_LENGTH, centre, threshold, buffer, offset);
 }
 
 /* */
@@ -431,10 +384,10 @@ void DMRSlotRX::writeRSSIData(uint8_t* frame)
 {
 #if defined(SEND_RSSI_DATA)
     // Calculate RSSI average over a burst period. We don't take into account 2.5 ms at the beginning and 2.5 ms at the end
-    uint16_t start = m_startPtr + DMR_SYNC_LENGTH_SAMPLES / 2U;
+    uint16_t start = (m_startPtr + DMR_SYNC_LENGTH_SAMPLES / 2U) / DMR_RADIO_SYMBOL_LENGTH;
 
     uint32_t accum = 0U;
-    for (uint16_t i = 0U; i < (DMR_FRAME_LENGTH_SAMPLES - DMR_SYNC_LENGTH_SAMPLES); i++)
+    for (uint16_t i = 0U; i < (DMR_FRAME_LENGTH_SYMBOLS - DMR_SYNC_LENGTH_SYMBOLS); i++)
         accum += m_rssi[start++];
 
     uint16_t avg = accum / (DMR_FRAME_LENGTH_SAMPLES - DMR_SYNC_LENGTH_SAMPLES);
@@ -25,6 +25,9 @@ namespace dmr
     //  Constants
     // ---------------------------------------------------------------------------
 
+    const uint16_t DMR_SLOT_BUFFER_LENGTH_SAMPLES = 900U;
+    const uint16_t DMR_SLOT_RSSI_LENGTH = DMR_SLOT_BUFFER_LENGTH_SAMPLES / DMR_RADIO_SYMBOL_LENGTH;
+
     /**
      * @brief DMR Slot Receiver State
      * @ingroup dmr_mfw
@@ -82,7 +85,7 @@ namespace dmr
         bool m_slot;
 
         uint32_t m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-        q15_t m_buffer[900U];
+        q15_t m_buffer[DMR_SLOT_BUFFER_LENGTH_SAMPLES];
 
         uint16_t m_bitPtr;
         uint16_t m_dataPtr;
@@ -109,7 +112,9 @@ namespace dmr
 
         uint8_t m_type;
 
-        uint16_t m_rssi[900U];
+#if defined(SEND_RSSI_DATA)
+        uint16_t m_rssi[DMR_SLOT_RSSI_LENGTH];
+#endif
 
         /**
          * @brief Frame synchronization correlator.
@@ -29,8 +29,6 @@ const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
 
 const q15_t DMR_LEVELA = 1362;
 const q15_t DMR_LEVELB = 454;
-const q15_t DMR_LEVELC = -454;
-const q15_t DMR_LEVELD = -1362;
 
 // The PR FILL and BS Data Sync pattern.
 const uint8_t IDLE_DATA[] = { 
@@ -53,6 +51,8 @@ const uint8_t EMPTY_SHORT_LC[] = {
 const uint32_t STARTUP_COUNT = 20U;
 const uint32_t ABORT_COUNT = 6U;
 
+const uint32_t SAMPLES_PER_MS = 24U;     // At 24 kHz sample rate
+
 // ---------------------------------------------------------------------------
 //  Public Class Members
 // ---------------------------------------------------------------------------
@@ -60,9 +60,13 @@ const uint32_t ABORT_COUNT = 6U;
 /* Initializes a new instance of the DMRTX class. */
 
 DMRTX::DMRTX() :
-    m_fifo(),
-    m_modFilter(),
-    m_modState(),
+    m_fifo{ { DMR_FRAME_LENGTH_BYTES, DMR_FRAME_LENGTH_BYTES, DMR_TX_BUFFER_LEN, true },
+        { DMR_FRAME_LENGTH_BYTES, DMR_FRAME_LENGTH_BYTES, DMR_TX_BUFFER_LEN, true } },
+    m_modulator(),
+    m_waveCache(),
+    m_modTable(),
+    m_cacheKeys(),
+    m_cacheSamples(),
     m_state(DMRTXSTATE_IDLE),
     m_idle(),
     m_cachPtr(0U),
@@ -70,24 +74,25 @@ DMRTX::DMRTX() :
     m_newShortLC(),
     m_markBuffer(),
     m_poBuffer(),
+    m_poData(m_poBuffer),
+    m_poFifo(NULL),
     m_poLen(0U),
     m_poPtr(0U),
+    m_poCache(false),
     m_frameCount(0U),
     m_abortCount(),
     m_abort(),
+    m_sampleCount(0U),
+    m_maxAge(),
+    m_holdCount(),
+    m_lateCount(),
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U),
     m_cachATControl(0U)
 {
-    m_fifo[0U].reinitialize(DMR_TX_BUFFER_LEN);
-    m_fifo[1U].reinitialize(DMR_TX_BUFFER_LEN);
-
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-    m_modFilter.L = DMR_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RRC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
+    m_modulator.init(RRC_0_2_FILTER, RRC_0_2_FILTER_PHASE_LEN, DMR_RADIO_SYMBOL_LENGTH, m_modTable);
+    m_modulator.setLevels(DMR_LEVELA, DMR_LEVELB);
+    m_waveCache.init(&m_modulator, NULL, 0U, FSK_CACHE_ENTRIES, m_cacheKeys, m_cacheSamples, NULL);
 
     ::memcpy(m_newShortLC, EMPTY_SHORT_LC, 12U);
     ::memcpy(m_shortLC, EMPTY_SHORT_LC, 12U);
@@ -142,15 +147,22 @@ void DMRTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * DMR_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr];
+            uint8_t c = m_poData[m_poPtr];
             uint8_t m = m_markBuffer[m_poPtr];
             m_poPtr++;
 
-            writeByte(c, m);
+            writeByte(c, m, m_poCache);
 
             space -= 4U * DMR_RADIO_SYMBOL_LENGTH;
+            m_sampleCount += 4U * DMR_RADIO_SYMBOL_LENGTH;
 
             if (m_poPtr >= m_poLen) {
+                // Free the frame slot, if the frame was read from a FIFO
+                if (m_poFifo != NULL) {
+                    m_poFifo->release();
+                    m_poFifo = NULL;
+                }
+
                 m_poPtr = 0U;
                 m_poLen = 0U;
                 return;
@@ -163,23 +175,66 @@ void DMRTX::process()
 
 uint8_t DMRTX::writeData1(const uint8_t* data, uint8_t length)
 {
-    if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
-        return RSN_ILLEGAL_LENGTH;
+    uint8_t* buffer = reserveData1(length);
+    if (buffer != NULL)
+        ::memcpy(buffer, data + 1U, DMR_FRAME_LENGTH_BYTES);
 
-    uint16_t space = m_fifo[0U].getSpace();
-    DEBUG3("DMRTX::writeData1() dataLength/fifoLength", length, space);
-    if (space < DMR_FRAME_LENGTH_BYTES) {
-        m_fifo[0U].reset();
-        return RSN_RINGBUFF_FULL;
-    }
+    return commitData1(length);
+}
+
+/* Write slot 2 data to the local buffer. */
+
+uint8_t DMRTX::writeData2(const uint8_t* data, uint8_t length)
+{
+    uint8_t* buffer = reserveData2(length);
+    if (buffer != NULL)
+        ::memcpy(buffer, data + 1U, DMR_FRAME_LENGTH_BYTES);
+
+    return commitData2(length);
+}
+
+/* Reserves the slot 1 local buffer space for data, which the caller fills in place. */
+
+uint8_t* DMRTX::reserveData1(uint8_t length)
+{
+    if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
+        return NULL;
 
     if (m_abort[0U]) {
         m_fifo[0U].reset();
         m_abort[0U] = false;
     }
 
-    for (uint8_t i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++)
-        m_fifo[0U].put(data[i + 1U]);
+    return m_fifo[0U].reserve(DMR_FRAME_LENGTH_BYTES);
+}
+
+/* Reserves the slot 2 local buffer space for data, which the caller fills in place. */
+
+uint8_t* DMRTX::reserveData2(uint8_t length)
+{
+    if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
+        return NULL;
+
+    if (m_abort[1U]) {
+        m_fifo[1U].reset();
+        m_abort[1U] = false;
+    }
+
+    return m_fifo[1U].reserve(DMR_FRAME_LENGTH_BYTES);
+}
+
+/* Writes the slot 1 data filled in place since reserveData1() to the local buffer. */
+
+uint8_t DMRTX::commitData1(uint8_t length)
+{
+    if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
+        return RSN_ILLEGAL_LENGTH;
+
+    DEBUG3("DMRTX::commitData1() dataLength/fifoSpace", length, m_fifo[0U].getSpace());
+    if (!m_fifo[0U].commit(DMR_FRAME_LENGTH_BYTES, m_sampleCount)) {
+        m_fifo[0U].reset();
+        return RSN_RINGBUFF_FULL;
+    }
 
     // Start the TX if it isn't already on
     if (!m_tx)
@@ -188,28 +243,19 @@ uint8_t DMRTX::writeData1(const uint8_t* data, uint8_t length)
     return RSN_OK;
 }
 
-/* Write slot 2 data to the local buffer. */
+/* Writes the slot 2 data filled in place since reserveData2() to the local buffer. */
 
-uint8_t DMRTX::writeData2(const uint8_t* data, uint8_t length)
+uint8_t DMRTX::commitData2(uint8_t length)
 {
     if (length != (DMR_FRAME_LENGTH_BYTES + 1U))
         return RSN_ILLEGAL_LENGTH;
 
-    uint16_t space = m_fifo[1U].getSpace();
-    DEBUG3("DMRTX::writeData2() dataLength/fifoLength", length, space);
-    if (space < DMR_FRAME_LENGTH_BYTES) {
+    DEBUG3("DMRTX::commitData2() dataLength/fifoSpace", length, m_fifo[1U].getSpace());
+    if (!m_fifo[1U].commit(DMR_FRAME_LENGTH_BYTES, m_sampleCount)) {
         m_fifo[1U].reset();
         return RSN_RINGBUFF_FULL;
     }
 
-    if (m_abort[1U]) {
-        m_fifo[1U].reset();
-        m_abort[1U] = false;
-    }
-
-    for (uint8_t i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++)
-        m_fifo[1U].put(data[i + 1U]);
-
     // Start the TX if it isn't already on
     if (!m_tx)
         m_state = DMRTXSTATE_SLOT1;
@@ -258,6 +304,19 @@ uint8_t DMRTX::writeAbort(const uint8_t* data, uint8_t length)
     }
 }
 
+/* Sets the maximum time a frame may wait in each slot FIFO. */
+
+uint8_t DMRTX::setMaxQueueAge(const uint8_t* data, uint8_t length)
+{
+    if (length != 4U)
+        return RSN_ILLEGAL_LENGTH;
+
+    m_maxAge[0U] = ((data[0U] << 8) + data[1U]) * SAMPLES_PER_MS;
+    m_maxAge[1U] = ((data[2U] << 8) + data[3U]) * SAMPLES_PER_MS;
+
+    return RSN_OK;
+}
+
 /* Helper to set the start state for Tx. */
 
 void DMRTX::setStart(bool start)
@@ -279,18 +338,32 @@ void DMRTX::setCal(bool start)
     m_state = start ? DMRTXSTATE_CAL : DMRTXSTATE_IDLE;
 }
 
-/* Helper to get how much space the slot 1 ring buffer has for samples. */
+/* Helper to get how many frames the slot 1 ring buffer has space for. */
 
 uint8_t DMRTX::getSpace1() const
 {
-    return m_fifo[0U].getSpace() / (DMR_FRAME_LENGTH_BYTES + 2U);
+    return m_fifo[0U].getSpace();
 }
 
-/* Helper to get how much space the slot 2 ring buffer has for samples. */
+/* Helper to get how many frames the slot 2 ring buffer has space for. */
 
 uint8_t DMRTX::getSpace2() const
 {
-    return m_fifo[1U].getSpace() / (DMR_FRAME_LENGTH_BYTES + 2U);
+    return m_fifo[1U].getSpace();
+}
+
+/* Helper to get how many late frames were dropped from the slot 1 ring buffer. */
+
+uint32_t DMRTX::getLateCount1() const
+{
+    return m_lateCount[0U];
+}
+
+/* Helper to get how many late frames were dropped from the slot 2 ring buffer. */
+
+uint32_t DMRTX::getLateCount2() const
+{
+    return m_lateCount[1U];
 }
 
 /* Sets the ignore flags for setting the CACH Access Type bit. */
@@ -331,6 +404,9 @@ void DMRTX::setSymbolLvlAdj(int8_t level3Adj, int8_t level1Adj)
         m_symLevel1Adj = 0;
     if (m_symLevel1Adj < -128)
         m_symLevel1Adj = 0;
+
+    m_modulator.setLevels(DMR_LEVELA + m_symLevel3Adj, DMR_LEVELB + m_symLevel1Adj);
+    m_waveCache.clear();
 }
 
 /* Helper to reset data values to defaults for slot 1 FIFO. */
@@ -351,8 +427,13 @@ void DMRTX::resetFifo2()
 
 void DMRTX::resizeBuffer(uint16_t size)
 {
-    m_fifo[0U].reset();
-    m_fifo[1U].reset();
+    // The frame being transmitted is read from a FIFO in place, so it has to outlive it
+    if (m_poFifo != NULL) {
+        ::memcpy(m_poBuffer, m_poData, m_poLen);
+        m_poData = m_poBuffer;
+        m_poFifo = NULL;
+    }
+
     m_fifo[0U].reinitialize(size);
     m_fifo[1U].reinitialize(size);
 }
@@ -372,25 +453,57 @@ uint32_t DMRTX::getFrameCount()
 
 void DMRTX::createData(uint8_t slotIndex)
 {
-    if (m_fifo[slotIndex].getData() >= DMR_FRAME_LENGTH_BYTES && m_frameCount >= STARTUP_COUNT && m_abortCount[slotIndex] >= ABORT_COUNT) {
-        for (unsigned int i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++) {
-            m_poBuffer[i] = m_fifo[slotIndex].get();
-            m_markBuffer[i] = MARK_NONE;
-        }
+    // Frames only age while the slot can transmit them, not while it is held back for the startup
+    // or an abort
+    bool ready = m_frameCount >= STARTUP_COUNT && m_abortCount[slotIndex] >= ABORT_COUNT;
+    if (ready)
+        dropLate(slotIndex);
+    else
+        m_holdCount[slotIndex] = m_sampleCount;
+
+    if (m_fifo[slotIndex].getData() > 0U && ready) {
+        // The frame is transmitted straight from its FIFO slot
+        uint16_t length = 0U;
+        m_poData = m_fifo[slotIndex].get(length);
+        m_poFifo = &m_fifo[slotIndex];
+
+        // the calibration frames are static patterns
+        m_poCache = FSK_CACHE_FRAMES && m_modemState == STATE_DMR_CAL_1K;
     }
     else {
         m_abort[slotIndex] = false;
         // Transmit an idle message
-        for (unsigned int i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++) {
-            m_poBuffer[i] = m_idle[i];
-            m_markBuffer[i] = MARK_NONE;
-        }
+        m_poData = m_idle;
+        m_poCache = FSK_CACHE_FRAMES;
     }
 
+    ::memset(m_markBuffer, MARK_NONE, DMR_FRAME_LENGTH_BYTES);
+
     m_poLen = DMR_FRAME_LENGTH_BYTES;
     m_poPtr = 0U;
 }
 
+/* Helper to drop the frames that have waited too long in a slot FIFO. */
+
+void DMRTX::dropLate(uint8_t slotIndex)
+{
+    if (m_maxAge[slotIndex] == 0U)
+        return;
+
+    // Frames queued while the slot was held back are not late until it has been free for the maximum age
+    if ((m_sampleCount - m_holdCount[slotIndex]) <= m_maxAge[slotIndex])
+        return;
+
+    while (m_fifo[slotIndex].getData() > 0U) {
+        uint32_t age = m_sampleCount - m_fifo[slotIndex].getStamp();
+        if (age <= m_maxAge[slotIndex])
+            break;
+
+        m_fifo[slotIndex].drop();
+        m_lateCount[slotIndex]++;
+    }
+}
+
 /* Helper to generate the common access channel. */
 
 void DMRTX::createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex)
@@ -410,6 +523,7 @@ void DMRTX::createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex)
     }
 
     ::memcpy(m_poBuffer, m_shortLC + m_cachPtr, 3U);
+    m_poData = m_poBuffer;
     m_markBuffer[0U] = MARK_NONE;
     m_markBuffer[1U] = MARK_NONE;
     m_markBuffer[2U] = rxSlotIndex == 1U ? MARK_SLOT1 : MARK_SLOT2;
@@ -448,6 +562,7 @@ void DMRTX::createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex)
 
     m_poLen = DMR_CACH_LENGTH_BYTES;
     m_poPtr = 0U;
+    m_poCache = FSK_CACHE_FRAMES;
 
     m_cachPtr += 3U;
 }
@@ -483,41 +598,37 @@ void DMRTX::createCal()
         m_poLen = 15U;
     }
 
+    m_poData = m_poBuffer;
     m_poLen = DMR_FRAME_LENGTH_BYTES;
     m_poPtr = 0U;
+    m_poCache = FSK_CACHE_FRAMES || m_modemState == STATE_DMR_CAL;
 }
 
 /* Helper to write a raw byte to the DAC. */
 
-void DMRTX::writeByte(uint8_t c, uint8_t control)
+void DMRTX::writeByte(uint8_t c, uint8_t control, bool cache)
 {
-    q15_t inBuffer[4U];
     q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
 
-    const uint8_t MASK = 0xC0U;
+    uint8_t controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
+    ::memset(controlBuffer, MARK_NONE, DMR_RADIO_SYMBOL_LENGTH * 4U * sizeof(uint8_t));
+    controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 2U] = control;
 
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (DMR_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (DMR_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (DMR_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (DMR_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    if (cache) {
+        const q15_t* samples = m_waveCache.find(c, false);
+        if (samples != NULL) {
+            io.write(STATE_DMR, samples, DMR_RADIO_SYMBOL_LENGTH * 4U, controlBuffer);
+            return;
         }
     }
+    else {
+        m_waveCache.skip(c, false);
+    }
 
-    uint8_t controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
-    ::memset(controlBuffer, MARK_NONE, DMR_RADIO_SYMBOL_LENGTH * 4U * sizeof(uint8_t));
-    controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 2U] = control;
+    m_modulator.modulate(c, outBuffer);
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+    if (cache)
+        m_waveCache.store(outBuffer, NULL);
 
     io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U, controlBuffer);
 }
@@ -20,7 +20,8 @@
 
 #include "Defines.h"
 #include "dmr/DMRDefines.h"
-#include "SerialBuffer.h"
+#include "FSKModulator.h"
+#include "FrameBuffer.h"
 
 namespace dmr
 {
@@ -75,6 +76,32 @@ namespace dmr
          * @returns uint8_t Reason code.
          */
         uint8_t writeData2(const uint8_t* data, uint8_t length);
+        /**
+         * @brief Reserves the slot 1 local buffer space for data, which the caller fills in place and
+         *  then passes to commitData1().
+         * @param length Length of data (as for writeData1(), including the leading flag byte).
+         * @returns uint8_t* Buffer for the data following the flag byte, or NULL if there is no space.
+         */
+        uint8_t* reserveData1(uint8_t length);
+        /**
+         * @brief Reserves the slot 2 local buffer space for data, which the caller fills in place and
+         *  then passes to commitData2().
+         * @param length Length of data (as for writeData2(), including the leading flag byte).
+         * @returns uint8_t* Buffer for the data following the flag byte, or NULL if there is no space.
+         */
+        uint8_t* reserveData2(uint8_t length);
+        /**
+         * @brief Writes the slot 1 data filled in place since reserveData1() to the local buffer.
+         * @param length Length of data (as for writeData1(), including the leading flag byte).
+         * @returns uint8_t Reason code.
+         */
+        uint8_t commitData1(uint8_t length);
+        /**
+         * @brief Writes the slot 2 data filled in place since reserveData2() to the local buffer.
+         * @param length Length of data (as for writeData2(), including the leading flag byte).
+         * @returns uint8_t Reason code.
+         */
+        uint8_t commitData2(uint8_t length);
 
         /**
          * @brief Write short LC data to the local buffer.
@@ -90,6 +117,14 @@ namespace dmr
          * @returns uint8_t Reason code.
          */
         uint8_t writeAbort(const uint8_t* data, uint8_t length);
+        /**
+         * @brief Sets the maximum time a frame may wait in each slot FIFO, frames older than that are
+         *  dropped at the slot boundary.
+         * @param[in] data Buffer (slot 1 and slot 2 maximum age in milliseconds, 0 for no limit).
+         * @param length Length of buffer.
+         * @returns uint8_t Reason code.
+         */
+        uint8_t setMaxQueueAge(const uint8_t* data, uint8_t length);
 
         /**
          * @brief Helper to set the start state for Tx.
@@ -103,15 +138,25 @@ namespace dmr
         void setCal(bool start);
 
         /**
-         * @brief Helper to get how much space the slot 1 ring buffer has for samples.
-         * @returns uint8_t Amount of space in the slot 1 ring buffer.
+         * @brief Helper to get how many frames the slot 1 ring buffer has space for.
+         * @returns uint8_t Number of free frame slots in the slot 1 ring buffer.
          */
         uint8_t getSpace1() const;
         /**
-         * @brief Helper to get how much space the slot 2 ring buffer has for samples.
-         * @returns uint8_t Amount of space in the slot 2 ring buffer.
+         * @brief Helper to get how many frames the slot 2 ring buffer has space for.
+         * @returns uint8_t Number of free frame slots in the slot 2 ring buffer.
          */
         uint8_t getSpace2() const;
+        /**
+         * @brief Helper to get how many late frames were dropped from the slot 1 ring buffer.
+         * @returns uint32_t Number of late frames dropped from the slot 1 ring buffer.
+         */
+        uint32_t getLateCount1() const;
+        /**
+         * @brief Helper to get how many late frames were dropped from the slot 2 ring buffer.
+         * @returns uint32_t Number of late frames dropped from the slot 2 ring buffer.
+         */
+        uint32_t getLateCount2() const;
 
         /**
          * @brief Sets the ignore flags for setting the CACH Access Type bit.
@@ -152,11 +197,15 @@ namespace dmr
         uint32_t getFrameCount();
 
     private:
-        SerialBuffer m_fifo[2U];
+        FrameBuffer m_fifo[2U];
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
+        FSKModulator m_modulator;
+        FSKWaveCache m_waveCache;
 
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+        q31_t m_modTable[DMR_RADIO_SYMBOL_LENGTH * FSK_MOD_GROUPS_MAX * FSK_MOD_TABLE_LEN];
+
+        uint64_t m_cacheKeys[FSK_CACHE_ENTRIES];
+        q15_t m_cacheSamples[FSK_CACHE_ENTRIES * DMR_RADIO_SYMBOL_LENGTH * 4U];
 
         DMRTXSTATE m_state;
 
@@ -169,14 +218,22 @@ namespace dmr
         uint8_t m_markBuffer[40U];
 
         uint8_t m_poBuffer[40U];
+        const uint8_t* m_poData;
+        FrameBuffer* m_poFifo;
         uint16_t m_poLen;
         uint16_t m_poPtr;
+        bool m_poCache;
 
         uint32_t m_frameCount;
 
         uint32_t m_abortCount[2U];
         bool m_abort[2U];
 
+        uint32_t m_sampleCount;
+        uint32_t m_maxAge[2U];
+        uint32_t m_holdCount[2U];
+        uint32_t m_lateCount[2U];
+
         int8_t m_symLevel3Adj;
         int8_t m_symLevel1Adj;
 
@@ -187,6 +244,11 @@ namespace dmr
          * @param slotIndex 
          */
         void createData(uint8_t slotIndex);
+        /**
+         * @brief Helper to drop the frames that have waited too long in a slot FIFO.
+         * @param slotIndex 
+         */
+        void dropLate(uint8_t slotIndex);
         /**
          * @brief Helper to generate the common access channel.
          * @param txSlotIndex 
@@ -202,8 +264,9 @@ namespace dmr
          * @brief Helper to write a raw byte to the DAC.
          * @param c Byte.
          * @param control 
+         * @param cache Flag indicating the byte is part of a static pattern, whose samples are cached.
          */
-        void writeByte(uint8_t c, uint8_t control);
+        void writeByte(uint8_t c, uint8_t control, bool cache);
     };
 } // namespace dmr
 
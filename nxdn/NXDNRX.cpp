@@ -45,8 +45,7 @@ NXDNRX::NXDNRX() :
     m_startPtr(NOENDPTR),
     m_endPtr(NOENDPTR),
     m_fswPtr(NOENDPTR),
-    m_minFSWPtr(NOENDPTR),
-    m_maxFSWPtr(NOENDPTR),
+    m_syncWindow(),
     m_maxCorr(0),
     m_centre(),
     m_centreVal(0),
@@ -74,8 +73,7 @@ void NXDNRX::reset()
     m_endPtr = NOENDPTR;
 
     m_fswPtr = NOENDPTR;
-    m_minFSWPtr = NOENDPTR;
-    m_maxFSWPtr = NOENDPTR;
+    m_syncWindow.reset();
 
     m_maxCorr = 0;
     m_centreVal = 0;
@@ -93,13 +91,17 @@ void NXDNRX::reset()
 
 /* Sample P25 values from the air interface. */
 
-void NXDNRX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
+void NXDNRX::samples(const q15_t* samples, uint16_t* rssi, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++) {
+    for (uint16_t i = 0U; i < length; i++) {
         q15_t sample = samples[i];
 
+#if defined(SEND_RSSI_DATA)
         m_rssiAccum += rssi[i];
         m_rssiCount++;
+#else
+        (void)rssi;
+#endif
 
         m_bitBuffer[m_bitPtr] <<= 1;
         if (sample < 0)
@@ -161,13 +163,7 @@ void NXDNRX::processSample(q15_t sample)
         m_countdown--;
 
     if (m_countdown == 1U) {
-        m_minFSWPtr = m_fswPtr + NXDN_FRAME_LENGTH_SAMPLES - 1U;
-        if (m_minFSWPtr >= NXDN_FRAME_LENGTH_SAMPLES)
-            m_minFSWPtr -= NXDN_FRAME_LENGTH_SAMPLES;
-
-        m_maxFSWPtr = m_fswPtr + 1U;
-        if (m_maxFSWPtr >= NXDN_FRAME_LENGTH_SAMPLES)
-            m_maxFSWPtr -= NXDN_FRAME_LENGTH_SAMPLES;
+        m_syncWindow.open(m_fswPtr, NXDN_FRAME_LENGTH_SAMPLES);
 
         m_state = NXDNRXS_DATA;
         m_countdown  = 0U;
@@ -178,24 +174,13 @@ void NXDNRX::processSample(q15_t sample)
 
 void NXDNRX::processData(q15_t sample)
 {
-    if (m_minFSWPtr < m_maxFSWPtr) {
-        if (m_dataPtr >= m_minFSWPtr && m_dataPtr <= m_maxFSWPtr)
-            correlateSync();
-    } else {
-        if (m_dataPtr >= m_minFSWPtr || m_dataPtr <= m_maxFSWPtr)
-            correlateSync();
-    }
+    if (m_syncWindow.contains(m_dataPtr))
+        correlateSync();
 
     if (m_dataPtr == m_endPtr) {
         // Only update the centre and threshold if they are from a good sync
         if (m_lostCount == MAX_FSW_FRAMES) {
-            m_minFSWPtr = m_fswPtr + NXDN_FRAME_LENGTH_SAMPLES - 1U;
-        if (m_minFSWPtr >= NXDN_FRAME_LENGTH_SAMPLES)
-            m_minFSWPtr -= NXDN_FRAME_LENGTH_SAMPLES;
-
-        m_maxFSWPtr = m_fswPtr + 1U;
-        if (m_maxFSWPtr >= NXDN_FRAME_LENGTH_SAMPLES)
-            m_maxFSWPtr -= NXDN_FRAME_LENGTH_SAMPLES;
+            m_syncWindow.track(m_buffer, NXDN_FRAME_LENGTH_SAMPLES, NXDN_RADIO_SYMBOL_LENGTH, m_endPtr, m_fswPtr, m_centreVal, m_thresholdVal);
         }
 
         calculateLevels(m_startPtr, NXDN_FRAME_LENGTH_SYMBOLS);
@@ -219,6 +204,7 @@ void NXDNRX::processData(q15_t sample)
             m_endPtr = NOENDPTR;
             m_averagePtr = NOAVEPTR;
             m_countdown  = 0U;
+            m_syncWindow.reset();
             m_maxCorr = 0;
         } else {
             frame[0U] = m_lostCount == (MAX_FSW_FRAMES - 1U) ? 0x01U : 0x00U;
@@ -255,37 +241,9 @@ bool NXDNRX::correlateSync()
         if (ptr >= NXDN_FRAME_LENGTH_SAMPLES)
             ptr -= NXDN_FRAME_LENGTH_SAMPLES;
 
-        q31_t corr = 0;
-        q15_t min =  16000;
-        q15_t max = -16000;
-
-        for (uint8_t i = 0U; i < NXDN_FSW_LENGTH_SYMBOLS; i++) {
-            q15_t val = m_buffer[ptr];
-
-            if (val > max)
-                max = val;
-            if (val < min)
-                min = val;
-
-            switch (NXDN_FSW_SYMBOLS_VALUES[i]) {
-            case +3:
-                corr -= (val + val + val);
-                break;
-            case +1:
-                corr -= val;
-                break;
-            case -1:
-                corr += val;
-                break;
-            default:  // -3
-                corr += (val + val + val);
-                break;
-            }
-
-            ptr += NXDN_RADIO_SYMBOL_LENGTH;
-            if (ptr >= NXDN_FRAME_LENGTH_SAMPLES)
-                ptr -= NXDN_FRAME_LENGTH_SAMPLES;
-        }
+        q15_t min, max;
+        q31_t corr = correlateSymbols(m_buffer, NXDN_FRAME_LENGTH_SAMPLES, ptr, NXDN_FSW_SYMBOLS_VALUES, NXDN_FSW_LENGTH_SYMBOLS,
+            NXDN_RADIO_SYMBOL_LENGTH, min, max);
 
         if (corr > m_maxCorr) {
             if (m_averagePtr == NOAVEPTR) {
@@ -341,33 +299,8 @@ bool NXDNRX::correlateSync()
 
 void NXDNRX::calculateLevels(uint16_t start, uint16_t count)
 {
-    q15_t maxPos = -16000;
-    q15_t minPos =  16000;
-    q15_t maxNeg =  16000;
-    q15_t minNeg = -16000;
-
-    for (uint16_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start];
-
-        if (sample > 0) {
-            if (sample > maxPos)
-                maxPos = sample;
-            if (sample < minPos)
-                minPos = sample;
-        } else {
-            if (sample < maxNeg)
-                maxNeg = sample;
-            if (sample > minNeg)
-                minNeg = sample;
-        }
-
-        start += NXDN_RADIO_SYMBOL_LENGTH;
-        if (start >= NXDN_FRAME_LENGTH_SAMPLES)
-            start -= NXDN_FRAME_LENGTH_SAMPLES;
-    }
-
-    q15_t posThresh = (maxPos + minPos) >> 1;
-    q15_t negThresh = (maxNeg + minNeg) >> 1;
+    q15_t posThresh, negThresh;
+    symbolLevels(m_buffer, NXDN_FRAME_LENGTH_SAMPLES, start, count, NXDN_RADIO_SYMBOL_LENGTH, posThresh, negThresh);
 
     q15_t centre = (posThresh + negThresh) >> 1;
 
@@ -407,33 +340,5 @@ void NXDNRX::calculateLevels(uint16_t start, uint16_t count)
 
 void NXDNRX::samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
 {
-    for (uint16_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start] - centre;
-
-        if (sample < -threshold) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        } else if (sample < 0) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        } else if (sample < threshold) {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        } else {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-
-        start += NXDN_RADIO_SYMBOL_LENGTH;
-        if (start >= NXDN_FRAME_LENGTH_SAMPLES)
-            start -= NXDN_FRAME_LENGTH_SAMPLES;
-    }
+    sliceSymbols(m_buffer, NXDN_FRAME_LENGTH_SAMPLES, start, count, NXDN_RADIO_SYMBOL_LENGTH, centre, threshold, buffer, offset);
 }
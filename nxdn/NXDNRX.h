@@ -18,6 +18,7 @@
 
 #include "Defines.h"
 #include "nxdn/NXDNDefines.h"
+#include "SyncWindow.h"
 
 namespace nxdn
 {
@@ -60,7 +61,7 @@ namespace nxdn
          * @param rssi
          * @param length 
          */
-        void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, uint16_t* rssi, uint16_t length);
 
         /**
          * @brief Sets the NXDN sync correlation countdown.
@@ -79,8 +80,7 @@ namespace nxdn
         uint16_t m_endPtr;
 
         uint16_t m_fswPtr;
-        uint16_t m_minFSWPtr;
-        uint16_t m_maxFSWPtr;
+        SyncWindow m_syncWindow;
 
         q31_t m_maxCorr;
         q15_t m_centre[16U];
@@ -48,13 +48,9 @@ const uint16_t NXDN_SINC_FILTER_LEN = 22U;
 #if defined(NXDN_9600_BAUD)
 const q15_t NXDN_LEVELA =  1680;
 const q15_t NXDN_LEVELB =  560;
-const q15_t NXDN_LEVELC = -560;
-const q15_t NXDN_LEVELD = -1680;
 #else
 const q15_t NXDN_LEVELA =  735;
 const q15_t NXDN_LEVELB =  245;
-const q15_t NXDN_LEVELC = -245;
-const q15_t NXDN_LEVELD = -735;
 #endif
 
 // ---------------------------------------------------------------------------
@@ -64,32 +60,37 @@ const q15_t NXDN_LEVELD = -735;
 /* Initializes a new instance of the NXDNTX class. */
 
 NXDNTX::NXDNTX() :
-    m_fifo(NXDN_TX_BUFFER_LEN),
+    m_fifo(NXDN_FRAME_LENGTH_BYTES, NXDN_FRAME_LENGTH_BYTES, NXDN_TX_BUFFER_LEN),
     m_state(NXDNTXSTATE_NORMAL),
-    m_modFilter(),
+    m_modulator(),
     m_sincFilter(),
-    m_modState(),
+    m_waveCache(),
+    m_modTable(),
     m_sincState(),
+    m_cacheKeys(),
+    m_cacheSamples(),
+    m_cacheHistory(),
     m_poBuffer(),
+    m_poData(m_poBuffer),
     m_poLen(0U),
     m_poPtr(0U),
+    m_poCache(false),
     m_preambleCnt(240U), // 200ms
     m_txHang(3000U),     // 5s
     m_tailCnt(0U),
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U)
 {
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
     ::memset(m_sincState,  0x00U, 70U * sizeof(q15_t));
 
-    m_modFilter.L = NXDN_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RRC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
+    m_modulator.init(RRC_0_2_FILTER, RRC_0_2_FILTER_PHASE_LEN, NXDN_RADIO_SYMBOL_LENGTH, m_modTable);
+    m_modulator.setLevels(NXDN_LEVELA, NXDN_LEVELB);
 
     m_sincFilter.numTaps = NXDN_SINC_FILTER_LEN;
     m_sincFilter.pState = m_sincState;
     m_sincFilter.pCoeffs = NXDN_SINC_FILTER;
+
+    m_waveCache.init(&m_modulator, m_sincState, NXDN_SINC_FILTER_LEN, FSK_CACHE_ENTRIES, m_cacheKeys, m_cacheSamples, m_cacheHistory);
 }
 
 /* Process local buffer and transmit on the air interface. */
@@ -137,14 +138,17 @@ void NXDNTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * NXDN_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr++];
+            uint8_t c = m_poData[m_poPtr++];
 
-            writeByte(c);
+            writeByte(c, m_poCache);
 
             space -= 4U * NXDN_RADIO_SYMBOL_LENGTH;
             m_tailCnt = m_txHang;
 
             if (m_poPtr >= m_poLen) {
+                // free the frame slot, if the frame was read from the FIFO
+                m_fifo.release();
+
                 m_poPtr = 0U;
                 m_poLen = 0U;
                 return;
@@ -156,18 +160,35 @@ void NXDNTX::process()
 /* Write data to the local buffer. */
 
 uint8_t NXDNTX::writeData(const uint8_t* data, uint8_t length)
+{
+    uint8_t* buffer = reserveData(length);
+    if (buffer != NULL)
+        ::memcpy(buffer, data + 1U, NXDN_FRAME_LENGTH_BYTES);
+
+    return commitData(length);
+}
+
+/* Reserves the local buffer space for data, which the caller fills in place. */
+
+uint8_t* NXDNTX::reserveData(uint8_t length)
+{
+    if (length != (NXDN_FRAME_LENGTH_BYTES + 1U))
+        return NULL;
+
+    return m_fifo.reserve(NXDN_FRAME_LENGTH_BYTES);
+}
+
+/* Writes the data filled in place since reserveData() to the local buffer. */
+
+uint8_t NXDNTX::commitData(uint8_t length)
 {
     if (length != (NXDN_FRAME_LENGTH_BYTES + 1U))
         return RSN_ILLEGAL_LENGTH;
 
-    uint16_t space = m_fifo.getSpace();
-    DEBUG3("NXDNTX::writeData() dataLength/fifoLength", length, space);
-    if (space < NXDN_FRAME_LENGTH_BYTES)
+    DEBUG3("NXDNTX::commitData() dataLength/fifoSpace", length, m_fifo.getSpace());
+    if (!m_fifo.commit(NXDN_FRAME_LENGTH_BYTES))
         return RSN_RINGBUFF_FULL;
 
-    for (uint8_t i = 0U; i < NXDN_FRAME_LENGTH_BYTES; i++)
-        m_fifo.put(data[i + 1U]);
-
     return RSN_OK;
 }
 
@@ -213,6 +234,9 @@ void NXDNTX::setSymbolLvlAdj(int8_t level3Adj, int8_t level1Adj)
         m_symLevel1Adj = 0;
     if (m_symLevel1Adj < -128)
         m_symLevel1Adj = 0;
+
+    m_modulator.setLevels(NXDN_LEVELA + m_symLevel3Adj, NXDN_LEVELB + m_symLevel1Adj);
+    m_waveCache.clear();
 }
 
 /* Helper to set the calibration state for Tx. */
@@ -226,15 +250,20 @@ void NXDNTX::setCal(bool start)
 
 void NXDNTX::resizeBuffer(uint16_t size)
 {
-    m_fifo.reset();
+    // the frame being transmitted is read from the FIFO in place, so it has to outlive it
+    if (m_poData != m_poBuffer && m_poLen > 0U) {
+        ::memcpy(m_poBuffer, m_poData, m_poLen);
+        m_poData = m_poBuffer;
+    }
+
     m_fifo.reinitialize(size);
 }
 
-/* Helper to get how much space the ring buffer has for samples. */
+/* Helper to get how many frames the ring buffer has space for. */
 
 uint8_t NXDNTX::getSpace() const
 {
-    return m_fifo.getSpace() / NXDN_FRAME_LENGTH_BYTES;
+    return m_fifo.getSpace();
 }
 
 // ---------------------------------------------------------------------------
@@ -252,48 +281,45 @@ void NXDNTX::createData()
         m_poBuffer[m_poLen++] = NXDN_PREAMBLE[0U];
         m_poBuffer[m_poLen++] = NXDN_PREAMBLE[1U];
         m_poBuffer[m_poLen++] = NXDN_PREAMBLE[2U];
+
+        m_poData = m_poBuffer;
     }
     else {
+        // the frame is transmitted straight from its FIFO slot
+        m_poData = m_fifo.get(m_poLen);
         DEBUG2("NXDNTX::createData() fifoSpace", m_fifo.getSpace());
-        for (uint8_t i = 0U; i < NXDN_FRAME_LENGTH_BYTES; i++) {
-            m_poBuffer[m_poLen++] = m_fifo.get();
-        }
     }
 
+    // the preamble and the calibration frames are static patterns
+    m_poCache = !m_tx || (FSK_CACHE_FRAMES && m_modemState == STATE_NXDN_CAL);
     m_poPtr = 0U;
 }
 
 /* Helper to write a raw byte to the DAC. */
 
-void NXDNTX::writeByte(uint8_t c)
+void NXDNTX::writeByte(uint8_t c, bool cache)
 {
-    q15_t inBuffer[4U];
     q15_t intBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
     q15_t outBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
 
-    const uint8_t MASK = 0xC0U;
-
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (NXDN_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (NXDN_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (NXDN_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (NXDN_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    if (cache) {
+        const q15_t* samples = m_waveCache.find(c, false);
+        if (samples != NULL) {
+            io.write(STATE_NXDN, samples, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+            return;
         }
     }
+    else {
+        m_waveCache.skip(c, false);
+    }
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    m_modulator.modulate(c, intBuffer);
 
     ::arm_fir_fast_q15(&m_sincFilter, intBuffer, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
 
+    if (cache)
+        m_waveCache.store(outBuffer, intBuffer);
+
     io.write(STATE_NXDN, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
 }
 
@@ -301,13 +327,20 @@ void NXDNTX::writeByte(uint8_t c)
 
 void NXDNTX::writeSilence()
 {
-    q15_t inBuffer[4U] = {0x00U, 0x00U, 0x00U, 0x00U};
     q15_t intBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
     q15_t outBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    const q15_t* samples = m_waveCache.find(0U, true);
+    if (samples != NULL) {
+        io.write(STATE_NXDN, samples, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+        return;
+    }
+
+    m_modulator.silence(intBuffer);
 
     ::arm_fir_fast_q15(&m_sincFilter, intBuffer, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
 
+    m_waveCache.store(outBuffer, intBuffer);
+
     io.write(STATE_NXDN, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
 }
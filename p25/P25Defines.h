@@ -96,6 +96,10 @@ namespace p25
 
     // 522 = P25_PDU_FRAME_LENGTH_BYTES + 10 (BUFFER_LEN = P25_PDU_FRAME_LENGTH_BYTES + 10)
     const uint32_t  P25_TX_BUFFER_LEN = 522U;
+    // 432 = P25_TDULC_FRAME_LENGTH_BYTES * 8 (TSDU and TDULC frames of the priority lane)
+    const uint32_t  P25_TX_PRI_BUFFER_LEN = 432U;
+
+    const uint8_t   P25_TX_FLAG_PRIORITY = 0x80U;       //! Tx Data Flag: Queue in Priority Lane
 
     // Data Unit ID(s)
     const uint8_t   P25_DUID_HDU = 0x00U;               //! Header Data Unit
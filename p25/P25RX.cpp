@@ -43,12 +43,14 @@ P25RX::P25RX() :
     m_buffer(),
     m_bitPtr(0U),
     m_dataPtr(0U),
-    m_minSyncPtr(0U),
-    m_maxSyncPtr(NOENDPTR),
+    m_syncWindow(),
     m_startPtr(0U),
     m_endPtr(NOENDPTR),
-    m_pduEndPtr(NOENDPTR),
     m_syncPtr(0U),
+    m_pduFrame(),
+    m_pduPtr(0U),
+    m_pduSyncPtr(0U),
+    m_pduSymbols(0U),
     m_maxCorr(0),
     m_centre(),
     m_centreVal(0),
@@ -72,14 +74,15 @@ P25RX::P25RX() :
 
 void P25RX::reset()
 {
-    m_minSyncPtr = 0U;
-    m_maxSyncPtr = NOENDPTR;
+    m_syncWindow.reset();
 
     m_startPtr = 0U;
     m_endPtr = NOENDPTR;
-    m_pduEndPtr = NOENDPTR;
     m_syncPtr = 0U;
 
+    m_pduSyncPtr = 0U;
+    m_pduSymbols = 0U;
+
     m_bitPtr = 0U;
     m_bitBuffer[0U] = m_bitBuffer[1U] = m_bitBuffer[2U] = m_bitBuffer[3U] = m_bitBuffer[4U] = 0U;
 
@@ -103,13 +106,17 @@ void P25RX::reset()
 
 /* Sample P25 values from the air interface. */
 
-void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
+void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++) {
+    for (uint16_t i = 0U; i < length; i++) {
         q15_t sample = samples[i];
 
+#if defined(SEND_RSSI_DATA)
         m_rssiAccum += rssi[i];
         m_rssiCount++;
+#else
+        (void)rssi;
+#endif
 
         m_buffer[m_dataPtr] = sample;
 
@@ -150,27 +157,15 @@ void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
             if (m_countdown == 1U) {
                 // are we using LDU sync positions?
                 if (m_lduSyncPos) {
-                    m_minSyncPtr = m_syncPtr + P25_LDU_FRAME_LENGTH_SAMPLES - 1U;
-                    if (m_minSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                        m_minSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-
-                    m_maxSyncPtr = m_syncPtr + 1U;
-                    if (m_maxSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                        m_maxSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
+                    m_syncWindow.open(m_syncPtr, P25_LDU_FRAME_LENGTH_SAMPLES);
 
                     m_lostCount = MAX_SYNC_FRAMES;
                 } else {
-                    m_minSyncPtr = m_syncPtr + P25_HDU_FRAME_LENGTH_SAMPLES - 1U;
-                    if (m_minSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                        m_minSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-
-                    m_maxSyncPtr = m_syncPtr + P25_HDU_FRAME_LENGTH_SAMPLES + 1U;
-                    if (m_maxSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                        m_maxSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
+                    m_syncWindow.open(m_syncPtr + P25_HDU_FRAME_LENGTH_SAMPLES, P25_LDU_FRAME_LENGTH_SAMPLES);
                 }
 
                 DEBUG4("P25RX::samples() dataPtr/startPtr/endPtr", m_dataPtr, m_startPtr, m_endPtr);
-                DEBUG4("P25RX::samples() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_maxSyncPtr, m_minSyncPtr);
+                DEBUG4("P25RX::samples() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_syncWindow.getMaxPtr(), m_syncWindow.getMinPtr());
 
                 m_countdown = 0U;
 
@@ -180,18 +175,16 @@ void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
         }
 
         m_dataPtr++;
-        if (m_state != P25RXS_DATA) {
-            if (m_dataPtr >= P25_LDU_FRAME_LENGTH_SAMPLES) {
-                m_duid = 0xFFU;
-                m_dataPtr = 0U;
-            }
-        } else {
-            if (m_dataPtr >= P25_PDU_FRAME_LENGTH_SAMPLES) {
-                m_duid = 0xFFU;
-                m_dataPtr = 0U;
-            }
+        if (m_dataPtr >= P25_LDU_FRAME_LENGTH_SAMPLES) {
+            m_duid = 0xFFU;
+            m_dataPtr = 0U;
         }
 
+        // the PDU frames are longer than the sample buffer, they are timed by their own pointer
+        m_pduPtr++;
+        if (m_pduPtr >= P25_PDU_FRAME_LENGTH_SAMPLES)
+            m_pduPtr = 0U;
+
         m_bitPtr++;
         if (m_bitPtr >= P25_RADIO_SYMBOL_LENGTH)
             m_bitPtr = 0U;
@@ -222,9 +215,9 @@ void P25RX::processSample(q15_t sample)
 {
     // initial sample processing does not have an end pointer -- we simply wait till we've read
     // the samples up to the maximum sync pointer
-    if (m_dataPtr == m_maxSyncPtr) {
-        DEBUG4("P25RX::processSample() dataPtr/startPtr/endPtr", m_dataPtr, m_startPtr, m_maxSyncPtr);
-        DEBUG4("P25RX::processSample() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_maxSyncPtr, m_minSyncPtr);
+    if (m_dataPtr == m_syncWindow.getMaxPtr()) {
+        DEBUG4("P25RX::processSample() dataPtr/startPtr/endPtr", m_dataPtr, m_startPtr, m_syncWindow.getMaxPtr());
+        DEBUG4("P25RX::processSample() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_syncWindow.getMaxPtr(), m_syncWindow.getMinPtr());
 
         // calculateLevels(m_startPtr, P25_NID_LENGTH_SYMBOLS);
 
@@ -304,6 +297,9 @@ void P25RX::processSample(q15_t sample)
                 m_state = P25RXS_DATA;
                 m_maxCorr = 0;
                 m_lostCount = MAX_SYNC_FRAMES;
+
+                // the next sync is a PDU frame after this one
+                m_syncWindow.open(m_pduSyncPtr, P25_PDU_FRAME_LENGTH_SAMPLES);
                 break;
             case P25_DUID_TDULC:
                 {
@@ -335,13 +331,7 @@ void P25RX::processSample(q15_t sample)
 
         // late entry?
         if (!m_lduSyncPos) {
-            m_minSyncPtr = m_syncPtr + P25_LDU_FRAME_LENGTH_SAMPLES - 1U;
-            if (m_minSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                m_minSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-
-            m_maxSyncPtr = m_syncPtr + 1U;
-            if (m_maxSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                m_maxSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
+            m_syncWindow.open(m_syncPtr, P25_LDU_FRAME_LENGTH_SAMPLES);
 
             m_maxCorr = 0;
 
@@ -361,31 +351,19 @@ void P25RX::processSample(q15_t sample)
 
 void P25RX::processVoice(q15_t sample)
 {
-    if (m_minSyncPtr < m_maxSyncPtr) {
-        if (m_dataPtr >= m_minSyncPtr && m_dataPtr <= m_maxSyncPtr)
-            correlateSync();
-    }
-    else {
-        if (m_dataPtr >= m_minSyncPtr || m_dataPtr <= m_maxSyncPtr)
-            correlateSync();
-    }
+    if (m_syncWindow.contains(m_dataPtr))
+        correlateSync();
 
     // process voice frame
     if (m_dataPtr == m_endPtr) {
         if (m_lostCount == MAX_SYNC_FRAMES) {
-            m_minSyncPtr = m_syncPtr + P25_LDU_FRAME_LENGTH_SAMPLES - 1U;
-            if (m_minSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                m_minSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-
-            m_maxSyncPtr = m_syncPtr + 1U;
-            if (m_maxSyncPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                m_maxSyncPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
+            m_syncWindow.track(m_buffer, P25_LDU_FRAME_LENGTH_SAMPLES, P25_RADIO_SYMBOL_LENGTH, m_endPtr, m_syncPtr, m_centreVal, m_thresholdVal);
         }
 
         m_lostCount--;
 
         DEBUG4("P25RX::processVoice() dataPtr/startPtr/endPtr", m_dataPtr, m_startPtr, m_endPtr);
-        DEBUG4("P25RX::processVoice() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_maxSyncPtr, m_minSyncPtr);
+        DEBUG4("P25RX::processVoice() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_syncWindow.getMaxPtr(), m_syncWindow.getMinPtr());
 
         // we've not seen a data sync for too long, signal sync lost and change to P25RXS_NONE
         if (m_lostCount == 0U) {
@@ -453,10 +431,10 @@ void P25RX::writeLDUFrame()
         frame[217U] = (rssi >> 8) & 0xFFU;
         frame[218U] = (rssi >> 0) & 0xFFU;
 
-        serial.writeP25Data(false, frame, P25_LDU_FRAME_LENGTH_BYTES + 3U);
+        serial.writeP25Data(frame, P25_LDU_FRAME_LENGTH_BYTES + 3U);
     }
     else {
-        serial.writeP25Data(false, frame, P25_LDU_FRAME_LENGTH_BYTES + 1U);
+        serial.writeP25Data(frame, P25_LDU_FRAME_LENGTH_BYTES + 1U);
     }
 #else
     serial.writeP25Data(frame, P25_LDU_FRAME_LENGTH_BYTES + 1U);
@@ -467,32 +445,31 @@ void P25RX::writeLDUFrame()
 
 void P25RX::processData(q15_t sample)
 {
-    if (m_minSyncPtr < m_maxSyncPtr) {
-        if (m_dataPtr >= m_minSyncPtr && m_dataPtr <= m_maxSyncPtr)
-            correlateSync();
-    }
-    else {
-        if (m_dataPtr >= m_minSyncPtr || m_dataPtr <= m_maxSyncPtr)
-            correlateSync();
-    }
+    if (m_syncWindow.contains(m_pduPtr))
+        correlateSync();
 
-    // process data frame
-    if (m_dataPtr == m_pduEndPtr) {
+    // the samples of a PDU frame do not fit the sample buffer, so each symbol is sliced into the
+    // frame as its sample arrives
+    uint16_t offset = m_pduPtr + P25_PDU_FRAME_LENGTH_SAMPLES + P25_SYNC_LENGTH_SAMPLES - P25_RADIO_SYMBOL_LENGTH - m_pduSyncPtr;
+    while (offset >= P25_PDU_FRAME_LENGTH_SAMPLES)
+        offset -= P25_PDU_FRAME_LENGTH_SAMPLES;
+
+    if (offset <= P25_PDU_FRAME_LENGTH_SAMPLES - P25_RADIO_SYMBOL_LENGTH)
+        slicePDU(offset / P25_RADIO_SYMBOL_LENGTH + 1U);
+
+    // process data frame, once the sample of its last symbol has arrived
+    if (offset == P25_PDU_FRAME_LENGTH_SAMPLES - P25_RADIO_SYMBOL_LENGTH) {
         // only update the centre and threshold if they are from a good sync
         if (m_lostCount == MAX_SYNC_FRAMES) {
-            m_minSyncPtr = m_syncPtr + P25_PDU_FRAME_LENGTH_SAMPLES - 1U;
-            if (m_minSyncPtr >= P25_PDU_FRAME_LENGTH_SAMPLES)
-                m_minSyncPtr -= P25_PDU_FRAME_LENGTH_SAMPLES;
-
-            m_maxSyncPtr = m_syncPtr + 1U;
-            if (m_maxSyncPtr >= P25_PDU_FRAME_LENGTH_SAMPLES)
-                m_maxSyncPtr -= P25_PDU_FRAME_LENGTH_SAMPLES;
+            uint16_t endPtr = (m_dataPtr == 0U) ? P25_LDU_FRAME_LENGTH_SAMPLES - 1U : m_dataPtr - 1U;
+            m_syncWindow.track(m_buffer, P25_LDU_FRAME_LENGTH_SAMPLES, P25_RADIO_SYMBOL_LENGTH, endPtr, m_pduSyncPtr,
+                P25_PDU_FRAME_LENGTH_SAMPLES, m_centreVal, m_thresholdVal);
         }
 
         m_lostCount--;
 
-        DEBUG4("P25RX::processData() dataPtr/startPtr/pduEndPtr", m_dataPtr, m_startPtr, m_pduEndPtr);
-        DEBUG4("P25RX::processData() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_maxSyncPtr, m_minSyncPtr);
+        DEBUG4("P25RX::processData() dataPtr/startPtr/pduPtr", m_dataPtr, m_startPtr, m_pduPtr);
+        DEBUG4("P25RX::processData() lostCount/maxSyncPtr/minSyncPtr", m_lostCount, m_syncWindow.getMaxPtr(), m_syncWindow.getMinPtr());
 
         // we've not seen a data sync for too long, signal sync lost and change to P25RXS_NONE
         if (m_lostCount == 0U) {
@@ -505,7 +482,7 @@ void P25RX::processData(q15_t sample)
             reset();
         }
         else {
-            if (!decodeNid(m_startPtr)) {
+            if (!decodeNid(m_pduFrame + 1U + P25_SYNC_BYTES_LENGTH)) {
                 io.setDecode(false);
                 io.setADCDetection(false);
 
@@ -517,11 +494,12 @@ void P25RX::processData(q15_t sample)
 
                 DEBUG4("P25RX::processData() sync found in PDU pos/centre/threshold", m_syncPtr, m_centreVal, m_thresholdVal);
 
-                uint8_t frame[P25_PDU_FRAME_LENGTH_BYTES + 1U];
-                samplesToBits(m_startPtr, P25_PDU_FRAME_LENGTH_SYMBOLS, frame, 8U, m_centreVal, m_thresholdVal);
+                m_pduFrame[0U] = m_lostCount == (MAX_SYNC_FRAMES - 1U) ? 0x01U : 0x00U; // set sync flag
+                serial.writeP25Data(m_pduFrame, P25_PDU_FRAME_LENGTH_BYTES + 1U);
 
-                frame[0U] = m_lostCount == (MAX_SYNC_FRAMES - 1U) ? 0x01U : 0x00U; // set sync flag
-                serial.writeP25Data(frame, P25_PDU_FRAME_LENGTH_BYTES + 1U);
+                // without a sync, the next frame follows on from this one
+                m_startPtr = (m_startPtr + P25_PDU_FRAME_LENGTH_SAMPLES) % P25_LDU_FRAME_LENGTH_SAMPLES;
+                m_pduSymbols = 0U;
 
                 m_rssiAccum = 0U;
                 m_rssiCount = 0U;
@@ -532,6 +510,19 @@ void P25RX::processData(q15_t sample)
     }
 }
 
+/* Helper to slice the received PDU symbols, up to the given count, into the PDU frame. */
+
+void P25RX::slicePDU(uint16_t count)
+{
+    if (count <= m_pduSymbols)
+        return;
+
+    uint16_t ptr = (m_startPtr + m_pduSymbols * P25_RADIO_SYMBOL_LENGTH) % P25_LDU_FRAME_LENGTH_SAMPLES;
+    samplesToBits(ptr, count - m_pduSymbols, m_pduFrame, 8U + m_pduSymbols * 2U, m_centreVal, m_thresholdVal);
+
+    m_pduSymbols = count;
+}
+
 /* Frame synchronization correlator. */
 
 bool P25RX::correlateSync()
@@ -543,37 +534,9 @@ bool P25RX::correlateSync()
         if (ptr >= P25_LDU_FRAME_LENGTH_SAMPLES)
             ptr -= P25_LDU_FRAME_LENGTH_SAMPLES;
 
-        q31_t corr = 0;
-        q15_t min = 16000;
-        q15_t max = -16000;
-
-        for (uint8_t i = 0U; i < P25_SYNC_LENGTH_SYMBOLS; i++) {
-            q15_t val = m_buffer[ptr];
-
-            if (val > max)
-                max = val;
-            if (val < min)
-                min = val;
-
-            switch (P25_SYNC_SYMBOLS_VALUES[i]) {
-            case +3:
-                corr -= (val + val + val);
-                break;
-            case +1:
-                corr -= val;
-                break;
-            case -1:
-                corr += val;
-                break;
-            default:  // -3
-                corr += (val + val + val);
-                break;
-            }
-
-            ptr += P25_RADIO_SYMBOL_LENGTH;
-            if (ptr >= P25_LDU_FRAME_LENGTH_SAMPLES)
-                ptr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-        }
+        q15_t min, max;
+        q31_t corr = correlateSymbols(m_buffer, P25_LDU_FRAME_LENGTH_SAMPLES, ptr, P25_SYNC_SYMBOLS_VALUES, P25_SYNC_LENGTH_SYMBOLS,
+            P25_RADIO_SYMBOL_LENGTH, min, max);
 
         if (corr > m_maxCorr) {
             if (m_averagePtr == NOAVEPTR) {
@@ -619,11 +582,12 @@ bool P25RX::correlateSync()
                 m_endPtr = m_dataPtr + P25_LDU_FRAME_LENGTH_SAMPLES - P25_SYNC_LENGTH_SAMPLES - 1U;
                 if (m_endPtr >= P25_LDU_FRAME_LENGTH_SAMPLES)
                     m_endPtr -= P25_LDU_FRAME_LENGTH_SAMPLES;
-                m_pduEndPtr = m_dataPtr + P25_PDU_FRAME_LENGTH_SAMPLES - P25_SYNC_LENGTH_SAMPLES - 1U;
-                if (m_pduEndPtr >= P25_PDU_FRAME_LENGTH_SAMPLES)
-                    m_pduEndPtr -= P25_PDU_FRAME_LENGTH_SAMPLES;
 
-                DEBUG5("P25RX::correlateSync() dataPtr/startPtr/endPtr/pduEndPtr", m_dataPtr, startPtr, m_endPtr, m_pduEndPtr);
+                // a PDU frame is sliced again from its new start
+                m_pduSyncPtr = m_pduPtr;
+                m_pduSymbols = 0U;
+
+                DEBUG5("P25RX::correlateSync() dataPtr/startPtr/endPtr/pduPtr", m_dataPtr, startPtr, m_endPtr, m_pduPtr);
 
                 return true;
             }
@@ -644,6 +608,13 @@ bool P25RX::decodeNid(uint16_t start)
     uint8_t nid[P25_NID_LENGTH_BYTES];
     samplesToBits(nidStartPtr, P25_NID_LENGTH_SYMBOLS, nid, 0U, m_centreVal, m_thresholdVal);
 
+    return decodeNid(nid);
+}
+
+/* Helper to decode the P25 NID from its bits. */
+
+bool P25RX::decodeNid(const uint8_t* nid)
+{
     DEBUG3("P25RX::decodeNid() sync [b0 - b1]", nid[0], nid[1]);
 
     if (m_nac == 0xF7EU) {
@@ -669,34 +640,8 @@ bool P25RX::decodeNid(uint16_t start)
 
 void P25RX::calculateLevels(uint16_t start, uint16_t count)
 {
-    q15_t maxPos = -16000;
-    q15_t minPos = 16000;
-    q15_t maxNeg = 16000;
-    q15_t minNeg = -16000;
-
-    for (uint16_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start];
-
-        if (sample > 0) {
-            if (sample > maxPos)
-                maxPos = sample;
-            if (sample < minPos)
-                minPos = sample;
-        }
-        else {
-            if (sample < maxNeg)
-                maxNeg = sample;
-            if (sample > minNeg)
-                minNeg = sample;
-        }
-
-        start += P25_RADIO_SYMBOL_LENGTH;
-        if (start >= P25_LDU_FRAME_LENGTH_SAMPLES)
-            start -= P25_LDU_FRAME_LENGTH_SAMPLES;
-    }
-
-    q15_t posThresh = (maxPos + minPos) >> 1;
-    q15_t negThresh = (maxNeg + minNeg) >> 1;
+    q15_t posThresh, negThresh;
+    symbolLevels(m_buffer, P25_LDU_FRAME_LENGTH_SAMPLES, start, count, P25_RADIO_SYMBOL_LENGTH, posThresh, negThresh);
 
     q15_t centre = (posThresh + negThresh) >> 1;
 
@@ -737,36 +682,5 @@ void P25RX::calculateLevels(uint16_t start, uint16_t count)
 
 void P25RX::samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
 {
-    for (uint16_t i = 0U; i < count; i++) {
-        q15_t sample = m_buffer[start] - centre;
-
-        if (sample < -threshold) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-        else if (sample < 0) {
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else if (sample < threshold) {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, false);
-            offset++;
-        }
-        else {
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-            _WRITE_BIT(buffer, offset, true);
-            offset++;
-        }
-
-        start += P25_RADIO_SYMBOL_LENGTH;
-        if (start >= P25_LDU_FRAME_LENGTH_SAMPLES)
-            start -= P25_LDU_FRAME_LENGTH_SAMPLES;
-    }
+    sliceSymbols(m_buffer, P25_LDU_FRAME_LENGTH_SAMPLES, start, count, P25_RADIO_SYMBOL_LENGTH, centre, threshold, buffer, offset);
 }
@@ -19,6 +19,7 @@
 
 #include "Defines.h"
 #include "p25/P25Defines.h"
+#include "SyncWindow.h"
 
 namespace p25
 {
@@ -63,7 +64,7 @@ namespace p25
          * @param rssi
          * @param length 
          */
-        void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, uint16_t* rssi, uint16_t length);
 
         /**
          * @brief Sets the P25 NAC.
@@ -78,19 +79,22 @@ namespace p25
 
     private:
         uint32_t m_bitBuffer[P25_RADIO_SYMBOL_LENGTH];
-        q15_t m_buffer[P25_PDU_FRAME_LENGTH_SAMPLES];
+        q15_t m_buffer[P25_LDU_FRAME_LENGTH_SAMPLES];
 
         uint16_t m_bitPtr;
         uint16_t m_dataPtr;
 
-        uint16_t m_minSyncPtr;
-        uint16_t m_maxSyncPtr;
+        SyncWindow m_syncWindow;
 
         uint16_t m_startPtr;
         uint16_t m_endPtr;
-        uint16_t m_pduEndPtr;
         uint16_t m_syncPtr;
 
+        uint8_t m_pduFrame[P25_PDU_FRAME_LENGTH_BYTES + 1U];
+        uint16_t m_pduPtr;
+        uint16_t m_pduSyncPtr;
+        uint16_t m_pduSymbols;
+
         q31_t m_maxCorr;
         q15_t m_centre[16U];
         q15_t m_centreVal;
@@ -133,6 +137,11 @@ namespace p25
          * @param sample 
          */
         void processData(q15_t sample);
+        /**
+         * @brief Helper to slice the received PDU symbols, up to the given count, into the PDU frame.
+         * @param count Number of symbols of the frame received.
+         */
+        void slicePDU(uint16_t count);
 
         /**
          * @brief Frame synchronization correlator.
@@ -146,6 +155,12 @@ namespace p25
          * @returns bool True, if P25 NID was decoded, otherwise false.
          */
         bool decodeNid(uint16_t start);
+        /**
+         * @brief Helper to decode the P25 NID from its bits.
+         * @param nid NID bits.
+         * @returns bool True, if P25 NID was decoded, otherwise false.
+         */
+        bool decodeNid(const uint8_t* nid);
 
         /**
          * @brief 
@@ -41,13 +41,9 @@ const uint16_t LOWPASS_FILTER_LEN = 32U;
 #if defined(P25_ALTERNATE_SYM_LEVELS)
 const q15_t P25_LEVELA = 1500;
 const q15_t P25_LEVELB = 330;
-const q15_t P25_LEVELC = -330;
-const q15_t P25_LEVELD = -1500;
 #else
 const q15_t P25_LEVELA = 1220;
 const q15_t P25_LEVELB = 410;
-const q15_t P25_LEVELC = -410;
-const q15_t P25_LEVELD = -1220;
 #endif
 
 // ---------------------------------------------------------------------------
@@ -57,39 +53,45 @@ const q15_t P25_LEVELD = -1220;
 /* Initializes a new instance of the P25TX class. */
 
 P25TX::P25TX() :
-    m_fifo(P25_TX_BUFFER_LEN),
+    m_fifo(P25_TDULC_FRAME_LENGTH_BYTES, P25_PDU_FRAME_LENGTH_BYTES, P25_TX_BUFFER_LEN),
+    m_priFifo(P25_TDULC_FRAME_LENGTH_BYTES, P25_TDULC_FRAME_LENGTH_BYTES, P25_TX_PRI_BUFFER_LEN),
     m_state(P25TXSTATE_NORMAL),
-    m_modFilter(),
+    m_modulator(),
     m_lpFilter(),
-    m_modState(),
+    m_waveCache(),
+    m_modTable(),
     m_lpState(),
+    m_cacheKeys(),
+    m_cacheSamples(),
+    m_cacheHistory(),
     m_poBuffer(),
+    m_poData(m_poBuffer),
     m_poLen(0U),
     m_poPtr(0U),
+    m_poCache(false),
     m_preambleCnt(P25_FIXED_DELAY),
     m_txHang(P25_FIXED_TX_HANG),
     m_tailCnt(0U),
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U)
 {
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
     ::memset(m_lpState, 0x00U, 60U * sizeof(q15_t));
 
-    m_modFilter.L = P25_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
+    m_modulator.init(RC_0_2_FILTER, RC_0_2_FILTER_PHASE_LEN, P25_RADIO_SYMBOL_LENGTH, m_modTable);
+    m_modulator.setLevels(P25_LEVELA, P25_LEVELB);
 
     m_lpFilter.numTaps = LOWPASS_FILTER_LEN;
     m_lpFilter.pState = m_lpState;
     m_lpFilter.pCoeffs = LOWPASS_FILTER;
+
+    m_waveCache.init(&m_modulator, m_lpState, LOWPASS_FILTER_LEN, FSK_CACHE_ENTRIES, m_cacheKeys, m_cacheSamples, m_cacheHistory);
 }
 
 /* Process local buffer and transmit on the air interface. */
 
 void P25TX::process()
 {
-    if (m_fifo.getData() == 0U && m_poLen == 0U && m_tailCnt > 0U &&
+    if (m_fifo.getData() == 0U && m_priFifo.getData() == 0U && m_poLen == 0U && m_tailCnt > 0U &&
         m_state != P25TXSTATE_CAL) {
         // transmit silence until the hang timer has expired
         uint16_t space = io.getSpace();
@@ -102,13 +104,13 @@ void P25TX::process()
 
             if (m_tailCnt == 0U)
                 return;
-            if (m_fifo.getData() > 0U) {
+            if (m_fifo.getData() > 0U || m_priFifo.getData() > 0U) {
                 m_tailCnt = 0U;
                 return;
             }
         }
 
-        if (m_fifo.getData() == 0U && m_poLen == 0U)
+        if (m_fifo.getData() == 0U && m_priFifo.getData() == 0U && m_poLen == 0U)
             return;
     }
 
@@ -118,7 +120,7 @@ void P25TX::process()
             createCal();
         }
         else {
-            if (m_fifo.getData() == 0U)
+            if (m_fifo.getData() == 0U && m_priFifo.getData() == 0U)
                 return;
 
             createData();
@@ -133,14 +135,18 @@ void P25TX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * P25_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr++];
+            uint8_t c = m_poData[m_poPtr++];
 
-            writeByte(c);
+            writeByte(c, m_poCache);
 
             space -= 4U * P25_RADIO_SYMBOL_LENGTH;
             m_tailCnt = m_txHang;
 
             if (m_poPtr >= m_poLen) {
+                // frees the frame slots, if the frame was read from either lane
+                m_fifo.release();
+                m_priFifo.release();
+
                 m_poPtr = 0U;
                 m_poLen = 0U;
                 return;
@@ -153,28 +159,41 @@ void P25TX::process()
 
 uint8_t P25TX::writeData(const uint8_t* data, uint16_t length)
 {
-    if (length < (P25_TDU_FRAME_LENGTH_BYTES + 1U))
+    uint8_t* buffer = reserveData(data[0U], length);
+    if (buffer != NULL)
+        ::memcpy(buffer, data + 1U, length - 1U);
+
+    return commitData(data[0U], length);
+}
+
+/* Reserves the local buffer space for data, which the caller fills in place. */
+
+uint8_t* P25TX::reserveData(uint8_t flags, uint16_t length)
+{
+    if (length < (P25_TDU_FRAME_LENGTH_BYTES + 1U) || length > (P25_PDU_FRAME_LENGTH_BYTES + 1U))
+        return NULL;
+
+    // the priority lane only holds frames up to a TDULC in length
+    return getFifo(flags)->reserve(length - 1U);
+}
+
+/* Writes the data filled in place since reserveData() to the local buffer. */
+
+uint8_t P25TX::commitData(uint8_t flags, uint16_t length)
+{
+    if (length < (P25_TDU_FRAME_LENGTH_BYTES + 1U) || length > (P25_PDU_FRAME_LENGTH_BYTES + 1U))
+        return RSN_ILLEGAL_LENGTH;
+    if ((flags & P25_TX_FLAG_PRIORITY) == P25_TX_FLAG_PRIORITY && length > (P25_TDULC_FRAME_LENGTH_BYTES + 1U))
         return RSN_ILLEGAL_LENGTH;
 
-    uint16_t space = m_fifo.getSpace();
-    DEBUG3("P25TX::writeData() dataLength/fifoLength", length, space);
-    if (space < length) {
-        m_fifo.reset();
-        return RSN_RINGBUFF_FULL;
-    }
+    FrameBuffer* fifo = getFifo(flags);
 
-    if (length <= 255U) {
-        m_fifo.put(DVM_SHORT_FRAME_START);
-        m_fifo.put(length - 1U);
-    } else {
-        m_fifo.put(DVM_LONG_FRAME_START);
-        m_fifo.put(((length - 1U) >> 8U) & 0xFFU);
-        m_fifo.put((length - 1U) & 0xFFU);
+    DEBUG3("P25TX::commitData() dataLength/fifoSpace", length, fifo->getSpace());
+    if (!fifo->commit(length - 1U)) {
+        fifo->reset();
+        return RSN_RINGBUFF_FULL;
     }
 
-    for (uint16_t i = 0U; i < (length - 1U); i++)
-        m_fifo.put(data[i + 1U]);
-
     return RSN_OK;
 }
 
@@ -183,6 +202,7 @@ uint8_t P25TX::writeData(const uint8_t* data, uint16_t length)
 void P25TX::clear()
 {
     m_fifo.reset();
+    m_priFifo.reset();
 }
 
 /* Sets the FDMA preamble count. */
@@ -228,6 +248,9 @@ void P25TX::setSymbolLvlAdj(int8_t level3Adj, int8_t level1Adj)
         m_symLevel1Adj = 0;
     if (m_symLevel1Adj < -128)
         m_symLevel1Adj = 0;
+
+    m_modulator.setLevels(P25_LEVELA + m_symLevel3Adj, P25_LEVELB + m_symLevel1Adj);
+    m_waveCache.clear();
 }
 
 /* Helper to set the calibration state for Tx. */
@@ -241,15 +264,35 @@ void P25TX::setCal(bool start)
 
 void P25TX::resizeBuffer(uint16_t size)
 {
-    m_fifo.reset();
+    // the frame being transmitted is read from the FIFO in place, so it has to outlive it
+    if (m_poData != m_poBuffer && m_poLen > 0U) {
+        ::memcpy(m_poBuffer, m_poData, m_poLen);
+        m_poData = m_poBuffer;
+    }
+
     m_fifo.reinitialize(size);
 }
 
-/* Helper to get how much space the ring buffer has for samples. */
+/* Helper to get how many LDU sized frames the ring buffer has space for. */
 
 uint8_t P25TX::getSpace() const
 {
-    return m_fifo.getSpace() / P25_LDU_FRAME_LENGTH_BYTES;
+    // an LDU takes exactly four TDULC sized slots
+    return m_fifo.getSpace() / (P25_LDU_FRAME_LENGTH_BYTES / P25_TDULC_FRAME_LENGTH_BYTES);
+}
+
+/* Helper to get how many frame slots a lane has free. */
+
+uint16_t P25TX::getLaneSpace(P25TXLANE lane) const
+{
+    return (lane == P25TXLANE_PRIORITY) ? m_priFifo.getSpace() : m_fifo.getSpace();
+}
+
+/* Helper to get how many frames a lane has queued. */
+
+uint16_t P25TX::getLaneDepth(P25TXLANE lane) const
+{
+    return (lane == P25TXLANE_PRIORITY) ? m_priFifo.getData() : m_fifo.getData();
 }
 
 // ---------------------------------------------------------------------------
@@ -263,25 +306,24 @@ void P25TX::createData()
     if (!m_tx) {
         for (uint16_t i = 0U; i < m_preambleCnt; i++)
             m_poBuffer[m_poLen++] = P25_START_SYNC;
+
+        m_poData = m_poBuffer;
     }
     else {
-        uint8_t frameType = m_fifo.get();
-        uint16_t length = 0U;
-        switch (frameType) {
-        case DVM_SHORT_FRAME_START:
-            length = m_fifo.get();
-            break;
-        case DVM_LONG_FRAME_START:
-            length = ((m_fifo.get() & 0xFFU) << 8) + (m_fifo.get());
-            break;
+        // the frame is transmitted straight from its FIFO slots, trunking signalling queued in the
+        // priority lane goes out ahead of any queued voice or data
+        if (m_priFifo.getData() > 0U) {
+            m_poData = m_priFifo.get(m_poLen);
+            DEBUG3("P25TX::createData() dataLength/priFifoSpace", m_poLen, m_priFifo.getSpace());
         }
-
-        DEBUG3("P25TX::createData() dataLength/fifoSpace", length, m_fifo.getSpace());
-        for (uint16_t i = 0U; i < length; i++) {
-            m_poBuffer[m_poLen++] = m_fifo.get();
+        else {
+            m_poData = m_fifo.get(m_poLen);
+            DEBUG3("P25TX::createData() dataLength/fifoSpace", m_poLen, m_fifo.getSpace());
         }
     }
 
+    // the preamble and the calibration frames are static patterns
+    m_poCache = !m_tx || (FSK_CACHE_FRAMES && m_modemState == STATE_P25_CAL_1K);
     m_poPtr = 0U;
 }
 
@@ -298,41 +340,47 @@ void P25TX::createCal()
         m_poLen = P25_LDU_FRAME_LENGTH_BYTES;
     }
 
+    m_poData = m_poBuffer;
     m_poLen = P25_LDU_FRAME_LENGTH_BYTES;
     m_poPtr = 0U;
+    m_poCache = true;
+}
+
+/* Helper to get the FIFO of a data frame. */
+
+FrameBuffer* P25TX::getFifo(uint8_t flags)
+{
+    if ((flags & P25_TX_FLAG_PRIORITY) == P25_TX_FLAG_PRIORITY)
+        return &m_priFifo;
+
+    return &m_fifo;
 }
 
 /* Helper to write a raw byte to the DAC. */
 
-void P25TX::writeByte(uint8_t c)
+void P25TX::writeByte(uint8_t c, bool cache)
 {
-    q15_t inBuffer[4U];
     q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
     q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
 
-    const uint8_t MASK = 0xC0U;
-
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (P25_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (P25_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (P25_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (P25_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    if (cache) {
+        const q15_t* samples = m_waveCache.find(c, false);
+        if (samples != NULL) {
+            io.write(STATE_P25, samples, P25_RADIO_SYMBOL_LENGTH * 4U);
+            return;
         }
     }
+    else {
+        m_waveCache.skip(c, false);
+    }
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    m_modulator.modulate(c, intBuffer);
 
     ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
 
+    if (cache)
+        m_waveCache.store(outBuffer, intBuffer);
+
     io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
 }
 
@@ -340,13 +388,20 @@ void P25TX::writeByte(uint8_t c)
 
 void P25TX::writeSilence()
 {
-    q15_t inBuffer[4U] = { 0x00U, 0x00U, 0x00U, 0x00U };
     q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
     q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-    
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+
+    const q15_t* samples = m_waveCache.find(0U, true);
+    if (samples != NULL) {
+        io.write(STATE_P25, samples, P25_RADIO_SYMBOL_LENGTH * 4U);
+        return;
+    }
+
+    m_modulator.silence(intBuffer);
     
     ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+
+    m_waveCache.store(outBuffer, intBuffer);
     
     io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
 }
@@ -18,7 +18,8 @@
 #define __P25_TX_H__
 
 #include "Defines.h"
-#include "SerialBuffer.h"
+#include "FSKModulator.h"
+#include "FrameBuffer.h"
 
 namespace p25
 {
@@ -38,6 +39,15 @@ namespace p25
         P25TXSTATE_CAL      //! Calibration
     };
 
+    /**
+     * @brief P25 Transmitter FIFO Lane
+     * @ingroup p25_mfw
+     */
+    enum P25TXLANE {
+        P25TXLANE_NORMAL,   //! Normal (voice and data)
+        P25TXLANE_PRIORITY  //! Priority (TSDU and TDULC)
+    };
+
     // ---------------------------------------------------------------------------
     //  Class Declaration
     // ---------------------------------------------------------------------------
@@ -59,15 +69,31 @@ namespace p25
         void process();
 
         /**
-         * @brief Write data to the local buffer.
+         * @brief Write data to the local buffer. Frames flagged P25_TX_FLAG_PRIORITY are queued in the
+         *  priority lane, which is drained ahead of the normal lane at frame boundaries.
          * @param[in] data Buffer.
          * @param length Length of buffer.
          * @returns uint8_t Reason code.
          */
         uint8_t writeData(const uint8_t* data, uint16_t length);
+        /**
+         * @brief Reserves the local buffer space for data, which the caller fills in place and then
+         *  passes to commitData().
+         * @param flags Flag byte of data (selects the lane).
+         * @param length Length of data (as for writeData(), including the leading flag byte).
+         * @returns uint8_t* Buffer for the data following the flag byte, or NULL if there is no space.
+         */
+        uint8_t* reserveData(uint8_t flags, uint16_t length);
+        /**
+         * @brief Writes the data filled in place since reserveData() to the local buffer.
+         * @param flags Flag byte of data (as reserved).
+         * @param length Length of data (as for writeData(), including the leading flag byte).
+         * @returns uint8_t Reason code.
+         */
+        uint8_t commitData(uint8_t flags, uint16_t length);
 
         /**
-         * @brief Clears the local buffer.
+         * @brief Clears the local buffer (both lanes).
          */
         void clear();
 
@@ -94,31 +120,51 @@ namespace p25
         void setCal(bool start);
 
         /**
-         * @brief Helper to resize the FIFO buffer.
+         * @brief Helper to resize the FIFO buffer (of the normal lane).
          * @param size 
          */
         void resizeBuffer(uint16_t size);
 
         /**
-         * @brief Helper to get how much space the ring buffer has for samples.
-         * @returns uint8_t Amount of space in ring buffer for samples. 
+         * @brief Helper to get how many LDU sized frames the ring buffer has space for.
+         * @returns uint8_t Number of LDU sized frames.
          */
         uint8_t getSpace() const;
+        /**
+         * @brief Helper to get how many TDULC sized frame slots a lane has free.
+         * @param lane FIFO lane.
+         * @returns uint16_t Number of free frame slots.
+         */
+        uint16_t getLaneSpace(P25TXLANE lane) const;
+        /**
+         * @brief Helper to get how many frames a lane has queued.
+         * @param lane FIFO lane.
+         * @returns uint16_t Number of queued frames.
+         */
+        uint16_t getLaneDepth(P25TXLANE lane) const;
 
     private:
-        SerialBuffer m_fifo;
+        FrameBuffer m_fifo;
+        FrameBuffer m_priFifo;
 
         P25TXSTATE m_state;
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
+        FSKModulator m_modulator;
         arm_fir_instance_q15 m_lpFilter;
+        FSKWaveCache m_waveCache;
 
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+        q31_t m_modTable[P25_RADIO_SYMBOL_LENGTH * FSK_MOD_GROUPS_MAX * FSK_MOD_TABLE_LEN];
         q15_t m_lpState[60U];     // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
 
+        uint64_t m_cacheKeys[FSK_CACHE_ENTRIES];
+        q15_t m_cacheSamples[FSK_CACHE_ENTRIES * P25_RADIO_SYMBOL_LENGTH * 4U];
+        q15_t m_cacheHistory[FSK_CACHE_ENTRIES * P25_RADIO_SYMBOL_LENGTH * 4U];
+
         uint8_t m_poBuffer[1200U];
+        const uint8_t* m_poData;
         uint16_t m_poLen;
         uint16_t m_poPtr;
+        bool m_poCache;
 
         uint16_t m_preambleCnt;
         uint16_t m_txHang;
@@ -135,12 +181,19 @@ namespace p25
          * @brief Helper to generate calibration data.
          */
         void createCal();
+        /**
+         * @brief Helper to get the FIFO of a data frame.
+         * @param flags Flag byte of data.
+         * @returns FrameBuffer* FIFO of the lane the flags select.
+         */
+        FrameBuffer* getFifo(uint8_t flags);
 
         /**
          * @brief Helper to write a raw byte to the DAC.
          * @param c Byte.
+         * @param cache Flag indicating the byte is part of a static pattern, whose samples are cached.
          */
-        void writeByte(uint8_t c);
+        void writeByte(uint8_t c, bool cache);
         /**
          * @brief 
          */
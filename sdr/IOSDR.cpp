@@ -10,13 +10,17 @@
 #include "Globals.h"
 #include "IO.h"
 #include "sdr/Log.h"
+#include "sdr/ShmRing.h"
 
 #include <unistd.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <time.h>
 
-#include <vector>
+#include <algorithm>
+#include <atomic>
 
 #include <zmq.hpp>
 
@@ -26,23 +30,47 @@
 
 const uint16_t DC_OFFSET = 2048U;
 
+const uint32_t TX_SAMPLE_RATE = 24000U;
+const uint16_t TX_FRAME_SAMPLES = 720U;
+const int64_t TX_FRAME_PERIOD_NS = (int64_t(TX_FRAME_SAMPLES) * 1000000000LL) / TX_SAMPLE_RATE;   // 30ms
+
+const int64_t TX_IDLE_TICK_NS = 1000000LL;                  // 1ms
+const int64_t TX_FILL_TICK_NS = 250000LL;                   // 250us
+const int64_t TX_FILL_GRACE_NS = 5000000LL;                 // 5ms
+const int64_t TX_LATE_THRESHOLD_NS = 1000000LL;             // 1ms
+
+const uint8_t TX_FRAME_POOL_SIZE = 32U;
+
+const uint16_t RX_MESSAGE_SAMPLES = 4096U;
+const uint16_t RX_RSSI = 3U;
+const uint32_t RX_SHM_WAIT = 100U;                          // ms
+const uint32_t RX_FULL_BACKOFF = 1000U;                     // us
+
 // ---------------------------------------------------------------------------
 //  Globals Variables
 // ---------------------------------------------------------------------------
 
 static pthread_t m_threadTx;
-static pthread_mutex_t m_txLock;
 static pthread_t m_threadRx;
-static pthread_mutex_t m_rxLock;
 static pthread_t m_threadStatus;
 
 zmq::context_t m_zmqContextTx;
 zmq::socket_t m_zmqSocketTx;
-static std::vector<short> m_audioBufTx = std::vector<short>();
+// Tx frames are handed to ZMQ without copying; a frame slot stays busy until ZMQ releases it (see txFrameFree())
+static short m_txFramePool[TX_FRAME_POOL_SIZE][TX_FRAME_SAMPLES];
+static std::atomic<bool> m_txFrameBusy[TX_FRAME_POOL_SIZE];
+static short m_txFrameSpill[TX_FRAME_SAMPLES];
+static uint8_t m_txFrameSlot = 0U;
+static short* m_txFrame = m_txFramePool[0U];
+static uint16_t m_txFrameLen = 0U;
 
 zmq::context_t m_zmqContextRx;
 zmq::socket_t m_zmqSocketRx;
-static std::vector<short> m_audioBufRx = std::vector<short>();
+static short m_rxMessage[RX_MESSAGE_SAMPLES];
+
+// shared memory baseband transport, used in place of ZMQ when the endpoint is a shm:// URI
+static ShmRing m_shmTx;
+static ShmRing m_shmRx;
 
 static bool m_abort = false;
 
@@ -59,6 +87,121 @@ static bool m_p25Mode = false;
 static bool m_nxdnModeToggle = false;
 static bool m_nxdnMode = false;
 
+static uint32_t m_txFrames = 0U;
+static uint32_t m_txLateFrames = 0U;
+static uint32_t m_txUnderruns = 0U;
+static uint32_t m_txResyncs = 0U;
+static uint32_t m_txDropped = 0U;
+static int64_t m_txLatenessMax = 0;
+static int64_t m_txLatenessTotal = 0;
+
+/* Helper to offset a monotonic timestamp by the given number of nanoseconds. */
+
+static void timespecAdd(struct timespec& ts, int64_t ns)
+{
+    int64_t nsec = int64_t(ts.tv_nsec) + ns;
+    ts.tv_sec += time_t(nsec / 1000000000LL);
+    nsec %= 1000000000LL;
+    if (nsec < 0) {
+        ts.tv_sec--;
+        nsec += 1000000000LL;
+    }
+
+    ts.tv_nsec = long(nsec);
+}
+
+/* Helper to return the difference (in nanoseconds) between two monotonic timestamps. */
+
+static int64_t timespecDiff(const struct timespec& a, const struct timespec& b)
+{
+    return int64_t(a.tv_sec - b.tv_sec) * 1000000000LL + (int64_t(a.tv_nsec) - int64_t(b.tv_nsec));
+}
+
+/* Helper to sleep until the given absolute monotonic deadline. */
+
+static void sleepUntil(const struct timespec& deadline)
+{
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) { /* stub */ }
+}
+
+/* Helper to copy a run of received samples into a reserved span of the Rx sample ring (samples may be NULL if
+   the span was already filled). */
+
+static void storeRxSamples(const short* samples, SampleSpan& span)
+{
+    if (span.length == 0U)
+        return;
+
+    // samples arrive in host byte order, so they are stored as is
+    if (samples != nullptr)
+        ::memcpy(span.samples, samples, span.length * sizeof(uint16_t));
+    ::memset(span.control, MARK_NONE, span.length);
+#if defined(SEND_RSSI_DATA)
+    std::fill_n(span.rssi, span.length, RX_RSSI);
+#endif
+}
+
+/* Helper to return a Tx frame slot to the pool, once ZMQ has finished with it. */
+
+static void txFrameFree(void* data, void* hint)
+{
+    std::atomic<bool>* busy = (std::atomic<bool>*)hint;
+    busy->store(false, std::memory_order_release);
+}
+
+/* Helper to select the next free Tx frame slot. */
+
+static void nextTxFrame()
+{
+    m_txFrameLen = 0U;
+
+    for (uint8_t i = 1U; i <= TX_FRAME_POOL_SIZE; i++) {
+        uint8_t slot = (m_txFrameSlot + i) % TX_FRAME_POOL_SIZE;
+        if (!m_txFrameBusy[slot].load(std::memory_order_acquire)) {
+            m_txFrameSlot = slot;
+            m_txFrame = m_txFramePool[slot];
+            return;
+        }
+    }
+
+    // every slot is still queued in ZMQ (the SDR is not reading), gather into the spill frame which is dropped
+    m_txFrame = m_txFrameSpill;
+}
+
+/* Helper to send a complete Tx frame to the SDR. */
+
+static void sendTxFrame()
+{
+    if (m_txFrame == m_txFrameSpill) {
+        m_txDropped++;
+        nextTxFrame();
+        return;
+    }
+
+    if (m_shmTx.isOpen()) {
+        if (!m_shmTx.write(m_txFrame, TX_FRAME_SAMPLES))
+            m_txDropped++; // the SDR is not reading
+        nextTxFrame();
+        return;
+    }
+
+    m_txFrameBusy[m_txFrameSlot].store(true, std::memory_order_relaxed);
+
+    {
+        // if the send fails, the message is closed here and txFrameFree() releases the slot
+        zmq::message_t reply = zmq::message_t(m_txFrame, TX_FRAME_SAMPLES * sizeof(short), txFrameFree, &m_txFrameBusy[m_txFrameSlot]);
+        try
+        {
+            // an empty result means the send would have blocked (EAGAIN), and the frame is dropped
+            if (!m_zmqSocketTx.send(reply, zmq::send_flags::dontwait).has_value())
+                m_txDropped++;
+        }
+        catch(const zmq::error_t& zmqE) { m_txDropped++; }
+    }
+
+    nextTxFrame();
+}
+
 /*  */
 
 static void* modemStatusHelper(void* arg)
@@ -121,11 +264,11 @@ IO::~IO()
         ::pthread_join(m_threadStatus, NULL);
     }
 
-    ::pthread_mutex_destroy(&m_txLock);
-    ::pthread_mutex_destroy(&m_rxLock);
-
     m_zmqSocketTx.close();
     m_zmqSocketRx.close();
+
+    m_shmTx.close();
+    m_shmRx.close();
 }
 
 /* Hardware interrupt handler. */
@@ -135,32 +278,12 @@ void IO::interrupt()
     uint16_t sample = DC_OFFSET;
     uint8_t control = MARK_NONE;
 
-    ::pthread_mutex_lock(&m_txLock);
-    while (m_txBuffer.get(sample, control)) {
+    // the Tx sample ring is single-producer (IO::write()) / single-consumer (this thread), no lock needed; samples
+    // are gathered into the pending frame, which is released to the SDR by the Tx frame clock (see txThreadHelper())
+    while (m_txFrameLen < TX_FRAME_SAMPLES && m_txBuffer.get(sample, control)) {
         sample *= 5; // amplify by 12dB
-
-        if (m_audioBufTx.size() >= 720) {
-            zmq::message_t reply = zmq::message_t(720 * sizeof(short));
-            ::memcpy(reply.data(), (unsigned char*)m_audioBufTx.data(), 720 * sizeof(short));
-
-            try
-            {
-                m_zmqSocketTx.send(reply, zmq::send_flags::dontwait);
-            }
-            catch(const zmq::error_t& zmqE) { /* stub */ }
-
-            ::usleep(9600 * 3);
-            
-            m_audioBufTx.erase(m_audioBufTx.begin(), m_audioBufTx.begin() + 720);
-            m_audioBufTx.push_back((short)sample);
-        }
-        else
-            m_audioBufTx.push_back((short)sample);
+        m_txFrame[m_txFrameLen++] = (short)sample;
     }
-    ::pthread_mutex_unlock(&m_txLock);
-   
-    sample = 2048U;
-    m_watchdog++;
 }
 
 /* Gets the CPU type the firmware is running on. */
@@ -186,6 +309,17 @@ void IO::resetMCU()
     /* not supported for SDR devices */
 }
 
+/* Sets how far ahead of its on-air time each Tx frame is released to the SDR. */
+
+bool IO::setTXLead(uint16_t lead)
+{
+    if (lead > TX_LEAD_MAX)
+        return false;
+
+    m_txLead = lead;
+    return true;
+}
+
 // ---------------------------------------------------------------------------
 //  Private Class Members
 // ---------------------------------------------------------------------------
@@ -214,42 +348,47 @@ void IO::startInt()
     m_zmqContextRx = zmq::context_t(1);
     m_zmqSocketRx = zmq::socket_t(m_zmqContextRx, ZMQ_PULL);
 
-    try
-    {
-        ::LogMessage("Binding Tx socket to %s", m_zmqTx.c_str());
-        m_zmqSocketTx.bind(m_zmqTx);
+    if (ShmRing::isShmEndpoint(m_zmqTx)) {
+        if (!m_shmTx.isOpen()) {
+            ::LogMessage("Creating Tx shared memory ring %s", m_zmqTx.c_str());
+            if (!m_shmTx.open(m_zmqTx, true))
+                ::LogError("SHM Tx Ring: failed to create %s, err: %d", m_zmqTx.c_str(), errno);
+        }
     }
-    catch(const zmq::error_t& zmqE) { ::LogError("ZMQ Tx Socket: %s", zmqE.what()); }
-    catch(const std::exception& e) { ::LogError("ZMQ Tx Socket: %s", e.what()); }
-
-    try
-    {
-        ::LogMessage("Connecting Rx socket to %s", m_zmqRx.c_str());
-        m_zmqSocketRx.connect(m_zmqRx);
-        if (m_zmqSocketRx.connected()) {
-            ::LogMessage("ZMQ connected to remote ZMQ listener", m_zmqRx.c_str());
-        } else {
-            ::LogWarning("ZMQ failed to remote ZMQ listener, will continue to retry to connect", m_zmqRx.c_str());
+    else {
+        try
+        {
+            ::LogMessage("Binding Tx socket to %s", m_zmqTx.c_str());
+            m_zmqSocketTx.bind(m_zmqTx);
         }
+        catch(const zmq::error_t& zmqE) { ::LogError("ZMQ Tx Socket: %s", zmqE.what()); }
+        catch(const std::exception& e) { ::LogError("ZMQ Tx Socket: %s", e.what()); }
     }
-    catch(const zmq::error_t& zmqE) { ::LogError("ZMQ Rx Socket: %s", zmqE.what()); }
-    catch(const std::exception& e) { ::LogError("ZMQ Rx Socket: %s", e.what()); }
 
-    m_audioBufTx = std::vector<short>();
-    m_audioBufRx = std::vector<short>();
-
-    if (::pthread_mutex_init(&m_txLock, NULL) != 0) {
-        ::LogError("Tx thread lock failed?");
-        ::LogFinalise();
-        exit(-1);
+    if (ShmRing::isShmEndpoint(m_zmqRx)) {
+        if (!m_shmRx.isOpen()) {
+            ::LogMessage("Creating Rx shared memory ring %s", m_zmqRx.c_str());
+            if (!m_shmRx.open(m_zmqRx, true))
+                ::LogError("SHM Rx Ring: failed to create %s, err: %d", m_zmqRx.c_str(), errno);
+        }
     }
-
-    if (::pthread_mutex_init(&m_rxLock, NULL) != 0) {
-        ::LogError("Rx thread lock failed?");
-        ::LogFinalise();
-        exit(-2);
+    else {
+        try
+        {
+            ::LogMessage("Connecting Rx socket to %s", m_zmqRx.c_str());
+            m_zmqSocketRx.connect(m_zmqRx);
+            if (m_zmqSocketRx.connected()) {
+                ::LogMessage("ZMQ connected to remote ZMQ listener", m_zmqRx.c_str());
+            } else {
+                ::LogWarning("ZMQ failed to remote ZMQ listener, will continue to retry to connect", m_zmqRx.c_str());
+            }
+        }
+        catch(const zmq::error_t& zmqE) { ::LogError("ZMQ Rx Socket: %s", zmqE.what()); }
+        catch(const std::exception& e) { ::LogError("ZMQ Rx Socket: %s", e.what()); }
     }
 
+    nextTxFrame();
+
     ::pthread_create(&m_threadTx, NULL, txThreadHelper, this);
     ::pthread_create(&m_threadRx, NULL, rxThreadHelper, this);
     ::pthread_create(&m_threadStatus, NULL, modemStatusHelper, this);
@@ -326,11 +465,101 @@ void* IO::txThreadHelper(void* arg)
 {
     IO* p = (IO*)arg;
 
+    // Tx frames are released on absolute CLOCK_MONOTONIC deadlines, one TX_FRAME_SAMPLES frame per frame period
+    // measured from the start of the transmission; each frame is released m_txLead ahead of its on-air time, so
+    // scheduling jitter does not accumulate into drift and the SDR is never handed bursts faster than real time
+    struct timespec now, tick, epoch, release;
+    ::clock_gettime(CLOCK_MONOTONIC, &tick);
+    epoch = tick;
+
+    bool running = false;
+    uint32_t frame = 0U;
+
     while (!m_abort)
     {
-        if (p->m_txBuffer.getData() < 1)
-            usleep(20);
         p->interrupt();
+
+        if (!running) {
+            if (m_txFrameLen == 0U) {
+                // nothing to transmit, keep the watchdog running at the sample rate
+                timespecAdd(tick, TX_IDLE_TICK_NS);
+                sleepUntil(tick);
+                p->m_watchdog += uint32_t((TX_SAMPLE_RATE * TX_IDLE_TICK_NS) / 1000000000LL);
+                continue;
+            }
+
+            // start of a transmission, restart the frame clock
+            ::clock_gettime(CLOCK_MONOTONIC, &epoch);
+            frame = 0U;
+            running = true;
+
+            m_txFrames = m_txLateFrames = m_txUnderruns = m_txResyncs = m_txDropped = 0U;
+            m_txLatenessMax = m_txLatenessTotal = 0;
+        }
+
+        // frames inside the lead window are released immediately
+        const int64_t lead = int64_t(p->m_txLead) * 1000000LL;
+        release = epoch;
+        if (int64_t(frame) * TX_FRAME_PERIOD_NS > lead)
+            timespecAdd(release, int64_t(frame) * TX_FRAME_PERIOD_NS - lead);
+
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        if (m_txFrameLen < TX_FRAME_SAMPLES) {
+            // a short frame is held past its release time for a grace period, to give the modem time to refill
+            // the Tx sample ring
+            int64_t remaining = timespecDiff(release, now) + TX_FILL_GRACE_NS;
+            if (remaining > 0) {
+                tick = now;
+                timespecAdd(tick, remaining < TX_FILL_TICK_NS ? remaining : TX_FILL_TICK_NS);
+                sleepUntil(tick);
+                continue;
+            }
+
+            if (m_txFrameLen == 0U) {
+                // end of transmission
+                if (g_debug && m_txFrames > 0U) {
+                    ::LogDebug("IO::txThreadHelper() Tx frames %u, late %u, underruns %u, resyncs %u, dropped %u, lateness avg %.1f us max %.1f us",
+                        m_txFrames, m_txLateFrames, m_txUnderruns, m_txResyncs, m_txDropped,
+                        double(m_txLatenessTotal) / m_txFrames / 1000.0, double(m_txLatenessMax) / 1000.0);
+                }
+
+                running = false;
+                tick = now;
+                continue;
+            }
+
+            // Tx underrun, pad out the frame
+            while (m_txFrameLen < TX_FRAME_SAMPLES)
+                m_txFrame[m_txFrameLen++] = (short)(DC_OFFSET * 5U);
+            m_txUnderruns++;
+        }
+        else {
+            sleepUntil(release);
+            ::clock_gettime(CLOCK_MONOTONIC, &now);
+        }
+
+        int64_t lateness = timespecDiff(now, release);
+        if (lateness < 0)
+            lateness = 0;
+
+        m_txFrames++;
+        m_txLatenessTotal += lateness;
+        if (lateness > m_txLatenessMax)
+            m_txLatenessMax = lateness;
+        if (lateness > TX_LATE_THRESHOLD_NS)
+            m_txLateFrames++;
+
+        // if we have fallen further behind than the lead can absorb the SDR has already run dry, restart the frame
+        // clock from here rather than bursting out the backlog
+        if (lateness > lead + TX_FRAME_PERIOD_NS) {
+            timespecAdd(epoch, lateness);
+            m_txResyncs++;
+        }
+
+        sendTxFrame();
+
+        p->m_watchdog += TX_FRAME_SAMPLES;
+        frame++;
     }
 
     return NULL;
@@ -340,14 +569,16 @@ void* IO::txThreadHelper(void* arg)
 
 void IO::interruptRx()
 {
-    uint16_t sample = DC_OFFSET;
-    uint8_t control = MARK_NONE;
-    
-    zmq::message_t msg;
-    zmq::recv_result_t recv;
+    if (m_shmRx.isOpen()) {
+        interruptRxShm();
+        return;
+    }
+
+    // receive straight into the preallocated message buffer, rather than a new zmq::message_t per message
+    zmq::recv_buffer_result_t recv;
     try
     {
-        recv = m_zmqSocketRx.recv(msg, zmq::recv_flags::none);
+        recv = m_zmqSocketRx.recv(zmq::buffer(m_rxMessage, sizeof(m_rxMessage)), zmq::recv_flags::none);
     }
     catch(const zmq::error_t& zmqE) 
     {
@@ -365,22 +596,56 @@ void IO::interruptRx()
         }
     }
 
-    int size = msg.size();
-    if (size < 1)
+    if (!recv.has_value())
         return;
 
-    ::pthread_mutex_lock(&m_rxLock);
-    uint16_t space = m_rxBuffer.getSpace();
+    if (recv->truncated())
+        ::LogWarning("IO::interruptRx(): Rx message too large, %u bytes (max %u)", (uint32_t)recv->untruncated_size, (uint32_t)sizeof(m_rxMessage));
 
-    for (int i = 0; i < size; i += 2) {
-        short sample = 0;
-        ::memcpy(&sample, (unsigned char*)msg.data() + i, sizeof(short));
+    uint16_t length = uint16_t(recv->size / sizeof(short));
+    if (length < 1U)
+        return;
+
+    // the Rx sample ring is single-producer (this thread) / single-consumer (IO::process()), so the
+    // message is copied into the ring in (at most) two runs and published in one step
+    SampleSpan span[2U];
+    uint16_t count = m_rxBuffer.putBlock(length, span[0U], span[1U]);
+
+    storeRxSamples(m_rxMessage, span[0U]);
+    storeRxSamples(m_rxMessage + span[0U].length, span[1U]);
+
+    m_rxBuffer.commit(count);
+}
+
+/*  */
+
+void IO::interruptRxShm()
+{
+    uint32_t length = m_shmRx.waitForData(RX_SHM_WAIT);
+    if (length < 1U)
+        return;
+
+    if (length > RX_MESSAGE_SAMPLES)
+        length = RX_MESSAGE_SAMPLES;
+
+    // samples are read from the shared memory ring straight into the Rx sample ring; anything that does not fit
+    // is left in the shared memory ring
+    SampleSpan span[2U];
+    uint16_t count = m_rxBuffer.putBlock(uint16_t(length), span[0U], span[1U]);
+
+    // the shared memory ring still holds the samples, so it would report data again at once; give
+    // IO::process() time to drain the Rx sample ring rather than spinning on it
+    if (count == 0U) {
+        ::usleep(RX_FULL_BACKOFF);
+        return;
+    }
 
-        m_rxBuffer.put((uint16_t)sample, control);
-        m_rssiBuffer.put(3U);
+    for (uint8_t s = 0U; s < 2U; s++) {
+        m_shmRx.read((int16_t*)span[s].samples, span[s].length);
+        storeRxSamples(nullptr, span[s]);
     }
 
-    ::pthread_mutex_unlock(&m_rxLock);
+    m_rxBuffer.commit(count);
 }
 
 /*  */
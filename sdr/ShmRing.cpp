@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+#include "sdr/ShmRing.h"
+
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/* Helper to sleep on a (process shared) futex word while it holds the given value. */
+
+static void futexWait(std::atomic<uint32_t>* word, uint32_t value, uint32_t timeout)
+{
+    struct timespec ts;
+    ts.tv_sec = timeout / 1000U;
+    ts.tv_nsec = (timeout % 1000U) * 1000000L;
+
+    ::syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, value, &ts, NULL, 0);
+}
+
+/* Helper to wake all sleepers on a (process shared) futex word. */
+
+static void futexWake(std::atomic<uint32_t>* word)
+{
+    ::syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/* Helper to return the offset of the sample storage within a ring segment. */
+
+static size_t samplesOffset()
+{
+    return (sizeof(ShmRingHeader) + 63U) & ~size_t(63U);
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/* Initializes a new instance of the ShmRing class. */
+
+ShmRing::ShmRing() :
+    m_name(),
+    m_owner(false),
+    m_size(0U),
+    m_header(nullptr),
+    m_samples(nullptr),
+    m_mask(0U)
+{
+    /* stub */
+}
+
+/* Finalizes a instance of the ShmRing class. */
+
+ShmRing::~ShmRing()
+{
+    close();
+}
+
+/* Helper to test whether the given endpoint selects the shared memory transport. */
+
+bool ShmRing::isShmEndpoint(const std::string& endpoint)
+{
+    return endpoint.compare(0U, ::strlen(SHM_RING_PREFIX), SHM_RING_PREFIX) == 0;
+}
+
+/* Opens (and optionally creates) the ring segment named by the given endpoint. */
+
+bool ShmRing::open(const std::string& endpoint, bool create, uint32_t capacity)
+{
+    close();
+
+    if (!isShmEndpoint(endpoint) || endpoint.length() <= ::strlen(SHM_RING_PREFIX))
+        return false;
+
+    m_name = "/" + endpoint.substr(::strlen(SHM_RING_PREFIX));
+
+    int fd = -1;
+    if (create) {
+        uint32_t length = 1U;
+        while (length < capacity && length < 0x80000000U)
+            length <<= 1;
+        capacity = length;
+
+        ::shm_unlink(m_name.c_str());
+        fd = ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+        if (fd < 0)
+            return false;
+
+        m_size = samplesOffset() + capacity * sizeof(int16_t);
+        if (::ftruncate(fd, off_t(m_size)) < 0) {
+            ::close(fd);
+            ::shm_unlink(m_name.c_str());
+            return false;
+        }
+    }
+    else {
+        fd = ::shm_open(m_name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) < 0 || size_t(st.st_size) <= samplesOffset()) {
+            ::close(fd);
+            return false;
+        }
+
+        m_size = size_t(st.st_size);
+    }
+
+    void* ptr = ::mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        if (create)
+            ::shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    ShmRingHeader* header = (ShmRingHeader*)ptr;
+    if (create) {
+        header->version = SHM_RING_VERSION;
+        header->capacity = capacity;
+        header->reserved = 0U;
+        header->head.store(0U, std::memory_order_relaxed);
+        header->readerWaiting.store(0U, std::memory_order_relaxed);
+        header->tail.store(0U, std::memory_order_relaxed);
+        header->writerWaiting.store(0U, std::memory_order_relaxed);
+
+        // publish the magic last, so an attaching peer never sees a partially initialized header
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = SHM_RING_MAGIC;
+    }
+    else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        capacity = header->capacity;
+        if (header->magic != SHM_RING_MAGIC || header->version != SHM_RING_VERSION ||
+            capacity == 0U || (capacity & (capacity - 1U)) != 0U ||
+            samplesOffset() + capacity * sizeof(int16_t) > m_size) {
+            ::munmap(ptr, m_size);
+            return false;
+        }
+    }
+
+    m_owner = create;
+    m_header = header;
+    m_samples = (int16_t*)((uint8_t*)ptr + samplesOffset());
+    m_mask = capacity - 1U;
+    return true;
+}
+
+/* Closes the ring segment (and unlinks it, if this instance created it). */
+
+void ShmRing::close()
+{
+    if (m_header == nullptr)
+        return;
+
+    ::munmap(m_header, m_size);
+    if (m_owner)
+        ::shm_unlink(m_name.c_str());
+
+    m_header = nullptr;
+    m_samples = nullptr;
+    m_owner = false;
+    m_size = 0U;
+    m_mask = 0U;
+}
+
+/* Helper to get how much space the ring has for samples. */
+
+uint32_t ShmRing::getSpace() const
+{
+    return (m_mask + 1U) - getData();
+}
+
+/* Helper to get the number of samples in the ring. */
+
+uint32_t ShmRing::getData() const
+{
+    return m_header->head.load(std::memory_order_acquire) - m_header->tail.load(std::memory_order_acquire);
+}
+
+/* Writes samples to the ring (producer only). */
+
+bool ShmRing::write(const int16_t* samples, uint32_t length)
+{
+    uint32_t head = m_header->head.load(std::memory_order_relaxed);
+    uint32_t tail = m_header->tail.load(std::memory_order_acquire);
+    if ((m_mask + 1U) - (head - tail) < length)
+        return false;
+
+    uint32_t index = head & m_mask;
+    uint32_t first = (m_mask + 1U) - index;
+    if (first > length)
+        first = length;
+
+    ::memcpy(m_samples + index, samples, first * sizeof(int16_t));
+    ::memcpy(m_samples, samples + first, (length - first) * sizeof(int16_t));
+
+    // sequentially consistent, paired with the waiting flag (see waitForData())
+    m_header->head.store(head + length, std::memory_order_seq_cst);
+    if (m_header->readerWaiting.load(std::memory_order_seq_cst) != 0U)
+        futexWake(&m_header->head);
+
+    return true;
+}
+
+/* Reads samples from the ring (consumer only). */
+
+uint32_t ShmRing::read(int16_t* samples, uint32_t length)
+{
+    uint32_t tail = m_header->tail.load(std::memory_order_relaxed);
+    uint32_t head = m_header->head.load(std::memory_order_acquire);
+    if (length > head - tail)
+        length = head - tail;
+
+    uint32_t index = tail & m_mask;
+    uint32_t first = (m_mask + 1U) - index;
+    if (first > length)
+        first = length;
+
+    ::memcpy(samples, m_samples + index, first * sizeof(int16_t));
+    ::memcpy(samples + first, m_samples, (length - first) * sizeof(int16_t));
+
+    // sequentially consistent, paired with the waiting flag (see waitForSpace())
+    m_header->tail.store(tail + length, std::memory_order_seq_cst);
+    if (m_header->writerWaiting.load(std::memory_order_seq_cst) != 0U)
+        futexWake(&m_header->tail);
+
+    return length;
+}
+
+/* Waits for samples to be written to the ring (consumer only). */
+
+uint32_t ShmRing::waitForData(uint32_t timeout)
+{
+    uint32_t head = m_header->head.load(std::memory_order_acquire);
+    uint32_t tail = m_header->tail.load(std::memory_order_relaxed);
+    if (head != tail)
+        return head - tail;
+
+    // raise the waiting flag before re-checking head; the producer stores head before testing the flag, so
+    // either it sees the flag and wakes us, or we see the new head (and the futex will not sleep)
+    m_header->readerWaiting.store(1U, std::memory_order_seq_cst);
+    head = m_header->head.load(std::memory_order_seq_cst);
+    if (head == tail)
+        futexWait(&m_header->head, head, timeout);
+    m_header->readerWaiting.store(0U, std::memory_order_relaxed);
+
+    return m_header->head.load(std::memory_order_acquire) - tail;
+}
+
+/* Waits for space in the ring (producer only). */
+
+bool ShmRing::waitForSpace(uint32_t length, uint32_t timeout)
+{
+    uint32_t head = m_header->head.load(std::memory_order_relaxed);
+    uint32_t tail = m_header->tail.load(std::memory_order_acquire);
+    if ((m_mask + 1U) - (head - tail) >= length)
+        return true;
+
+    m_header->writerWaiting.store(1U, std::memory_order_seq_cst);
+    tail = m_header->tail.load(std::memory_order_seq_cst);
+    if ((m_mask + 1U) - (head - tail) < length)
+        futexWait(&m_header->tail, tail, timeout);
+    m_header->writerWaiting.store(0U, std::memory_order_relaxed);
+
+    tail = m_header->tail.load(std::memory_order_acquire);
+    return (m_mask + 1U) - (head - tail) >= length;
+}
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file ShmRing.h
+ * @ingroup modem_fw
+ * @file ShmRing.cpp
+ * @ingroup modem_fw
+ */
+#if !defined(__SHM_RING_H__)
+#define __SHM_RING_H__
+
+#include "Defines.h"
+
+#include <atomic>
+#include <string>
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief URI prefix selecting the shared memory baseband transport.
+ */
+#define SHM_RING_PREFIX "shm://"
+
+const uint32_t SHM_RING_MAGIC = 0x44564D53U;            // "DVMS"
+const uint32_t SHM_RING_VERSION = 1U;
+const uint32_t SHM_RING_DEFAULT_CAPACITY = 16384U;      // samples
+
+// ---------------------------------------------------------------------------
+//  Structure Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Header at the start of a shared memory baseband ring segment.
+ *  The sample storage (capacity 16-bit host byte order samples) follows the header.
+ * @ingroup modem_fw
+ */
+struct ShmRingHeader {
+    uint32_t magic;                                 //!< SHM_RING_MAGIC, once the segment is initialized.
+    uint32_t version;                               //!< SHM_RING_VERSION.
+    uint32_t capacity;                              //!< Ring capacity in samples (power of two).
+    uint32_t reserved;
+
+    alignas(64) std::atomic<uint32_t> head;         //!< Free-running write index (producer owned).
+    std::atomic<uint32_t> readerWaiting;            //!< Flag set while the consumer sleeps on head.
+
+    alignas(64) std::atomic<uint32_t> tail;         //!< Free-running read index (consumer owned).
+    std::atomic<uint32_t> writerWaiting;            //!< Flag set while the producer sleeps on tail.
+};
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Implements a single-producer/single-consumer ring of baseband samples in a POSIX
+ *  shared memory segment, used to exchange samples with an SDR front end on the same host.
+ *  Either side may sleep on the other with a (process shared) futex on the ring indices.
+ * @ingroup modem_fw
+ */
+class DSP_FW_API ShmRing {
+public:
+    /**
+     * @brief Initializes a new instance of the ShmRing class.
+     */
+    ShmRing();
+    /**
+     * @brief Finalizes a instance of the ShmRing class.
+     */
+    ~ShmRing();
+
+    /**
+     * @brief Helper to test whether the given endpoint selects the shared memory transport.
+     * @param endpoint Endpoint URI.
+     * @returns bool True, if the endpoint is a shm:// URI, otherwise false.
+     */
+    static bool isShmEndpoint(const std::string& endpoint);
+
+    /**
+     * @brief Opens (and optionally creates) the ring segment named by the given endpoint.
+     *  Creating a segment (re)initializes it, discarding any samples left in it.
+     * @param endpoint Endpoint URI (shm://name).
+     * @param create Flag indicating the segment should be created and initialized.
+     * @param capacity Ring capacity in samples, when creating (rounded up to a power of two).
+     * @returns bool True, if the ring was opened, otherwise false.
+     */
+    bool open(const std::string& endpoint, bool create, uint32_t capacity = SHM_RING_DEFAULT_CAPACITY);
+    /**
+     * @brief Closes the ring segment (and unlinks it, if this instance created it).
+     */
+    void close();
+    /**
+     * @brief Flag indicating whether the ring is open.
+     * @returns bool True, if the ring is open, otherwise false.
+     */
+    bool isOpen() const { return m_header != nullptr; }
+
+    /**
+     * @brief Helper to get how much space the ring has for samples.
+     * @returns uint32_t Number of samples that can be written.
+     */
+    uint32_t getSpace() const;
+    /**
+     * @brief Helper to get the number of samples in the ring.
+     * @returns uint32_t Number of samples that can be read.
+     */
+    uint32_t getData() const;
+
+    /**
+     * @brief Writes samples to the ring (producer only). The write is all or nothing.
+     * @param samples Samples to write.
+     * @param length Number of samples to write.
+     * @returns bool True, if the samples were written, otherwise false (not enough space).
+     */
+    bool write(const int16_t* samples, uint32_t length);
+    /**
+     * @brief Reads samples from the ring (consumer only).
+     * @param samples Buffer to read samples into.
+     * @param length Maximum number of samples to read.
+     * @returns uint32_t Number of samples read.
+     */
+    uint32_t read(int16_t* samples, uint32_t length);
+
+    /**
+     * @brief Waits for samples to be written to the ring (consumer only).
+     * @param timeout Maximum time to wait in milliseconds.
+     * @returns uint32_t Number of samples that can be read (0 on timeout).
+     */
+    uint32_t waitForData(uint32_t timeout);
+    /**
+     * @brief Waits for space in the ring (producer only).
+     * @param length Number of samples of space required.
+     * @param timeout Maximum time to wait in milliseconds.
+     * @returns bool True, if the space is available, otherwise false (timeout).
+     */
+    bool waitForSpace(uint32_t length, uint32_t timeout);
+
+private:
+    std::string m_name;
+    bool m_owner;
+
+    size_t m_size;
+    ShmRingHeader* m_header;
+    int16_t* m_samples;
+    uint32_t m_mask;
+};
+
+#endif // __SHM_RING_H__
@@ -8,8 +8,30 @@
  *
  */
 #include <stdint.h>
+#include <string.h>
 #include "sdr/arm_math.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ARM_MATH_X86_SIMD
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ARM_MATH_NEON_SIMD
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif // defined(__linux__)
+#endif
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// shorter filters are not worth the SIMD setup/reduction, and take the scalar path
+const uint16_t FIR_SIMD_MIN_TAPS = 8U;
+// the most consecutive outputs the block kernels compute at once
+const uint32_t FIR_BLOCK_OUTPUTS_MAX = 4U;
+
 // ---------------------------------------------------------------------------
 //  Macros
 // ---------------------------------------------------------------------------
@@ -139,9 +161,9 @@ void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* p
     }
 }
 
-/* Processing function for the fast Q15 FIR filter for Cortex-M3 and Cortex-M4. */
+/* Scalar processing function for the fast Q15 FIR filter for Cortex-M3 and Cortex-M4. */
 
-void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+static void firFastScalar(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
 {
     q15_t *pState = S->pState;                     // State pointer
     q15_t *pCoeffs = S->pCoeffs;                   // Coefficient pointer
@@ -406,6 +428,353 @@ void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, u
     }
 }
 
+// ---------------------------------------------------------------------------
+//  SIMD Kernels
+// ---------------------------------------------------------------------------
+
+/*
+** The host kernels below compute exactly the same sums as the scalar emulation above; the fast FIR accumulates
+** in 32-bits (wrapping, like SMLAD), and as wrapping integer addition is associative the lane order does not
+** change the result, so the output is bit-exact with the scalar code (and the MCU).
+**
+** The interpolator is left scalar, with only 8 - 9 (strided) taps per phase a SIMD version measured slower than
+** the scalar code on the host; the biquad is a recursion, which leaves nothing to spread across lanes.
+*/
+
+#if defined(ARM_MATH_X86_SIMD)
+/* SSE4.1 Q15 dot product, 32-bit accumulation. */
+
+__attribute__((target("sse4.1")))
+static uint32_t firDotSSE41(const q15_t* x, const q15_t* c, uint32_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+
+    uint32_t i = 0U;
+    for (; i + 8U <= n; i += 8U) {
+        __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i vc = _mm_loadu_si128((const __m128i*)(c + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(vx, vc));
+    }
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(acc);
+
+    for (; i < n; i++)
+        sum += (uint32_t)((q31_t)x[i] * c[i]);
+
+    return sum;
+}
+
+/* AVX2 Q15 dot product, 32-bit accumulation. */
+
+__attribute__((target("avx2")))
+static uint32_t firDotAVX2(const q15_t* x, const q15_t* c, uint32_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+
+    uint32_t i = 0U;
+    for (; i + 16U <= n; i += 16U) {
+        __m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i vc = _mm256_loadu_si256((const __m256i*)(c + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(vx, vc));
+    }
+
+    __m128i acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    if (i + 8U <= n) {
+        __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i vc = _mm_loadu_si128((const __m128i*)(c + i));
+        acc128 = _mm_add_epi32(acc128, _mm_madd_epi16(vx, vc));
+        i += 8U;
+    }
+
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(acc128);
+
+    for (; i < n; i++)
+        sum += (uint32_t)((q31_t)x[i] * c[i]);
+
+    return sum;
+}
+
+/* SSE4.1 Q15 dot products of a coefficient vector with OUTPUTS consecutive windows of the input, 32-bit accumulation. */
+
+template <uint32_t OUTPUTS>
+__attribute__((target("sse4.1")))
+static void firDotBlockSSE41(const q15_t* x, const q15_t* c, uint32_t n, uint32_t* result)
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128();
+    __m128i acc3 = _mm_setzero_si128();
+
+    // each chunk of coefficients is loaded once for all of the outputs
+    uint32_t i = 0U;
+    for (; i + 8U <= n; i += 8U) {
+        __m128i vc = _mm_loadu_si128((const __m128i*)(c + i));
+        acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i))));
+        if (OUTPUTS > 1U)
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 1U))));
+        if (OUTPUTS > 2U)
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 2U))));
+        if (OUTPUTS > 3U)
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 3U))));
+    }
+
+    // lane j of the result is the sum of accumulator j
+    __m128i sum = _mm_hadd_epi32(_mm_hadd_epi32(acc0, acc1), _mm_hadd_epi32(acc2, acc3));
+    uint32_t sums[4U];
+    _mm_storeu_si128((__m128i*)sums, sum);
+
+    for (uint32_t j = 0U; j < OUTPUTS; j++) {
+        for (uint32_t k = i; k < n; k++)
+            sums[j] += (uint32_t)((q31_t)x[k + j] * c[k]);
+        result[j] = sums[j];
+    }
+}
+
+/* AVX2 Q15 dot products of a coefficient vector with OUTPUTS consecutive windows of the input, 32-bit accumulation. */
+
+template <uint32_t OUTPUTS>
+__attribute__((target("avx2")))
+static void firDotBlockAVX2(const q15_t* x, const q15_t* c, uint32_t n, uint32_t* result)
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+
+    // each chunk of coefficients is loaded once for all of the outputs
+    uint32_t i = 0U;
+    for (; i + 16U <= n; i += 16U) {
+        __m256i vc = _mm256_loadu_si256((const __m256i*)(c + i));
+        acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(vc, _mm256_loadu_si256((const __m256i*)(x + i))));
+        if (OUTPUTS > 1U)
+            acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(vc, _mm256_loadu_si256((const __m256i*)(x + i + 1U))));
+        if (OUTPUTS > 2U)
+            acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(vc, _mm256_loadu_si256((const __m256i*)(x + i + 2U))));
+        if (OUTPUTS > 3U)
+            acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(vc, _mm256_loadu_si256((const __m256i*)(x + i + 3U))));
+    }
+
+    __m128i sum0 = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+    __m128i sum1 = _mm_add_epi32(_mm256_castsi256_si128(acc1), _mm256_extracti128_si256(acc1, 1));
+    __m128i sum2 = _mm_add_epi32(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1));
+    __m128i sum3 = _mm_add_epi32(_mm256_castsi256_si128(acc3), _mm256_extracti128_si256(acc3, 1));
+    if (i + 8U <= n) {
+        __m128i vc = _mm_loadu_si128((const __m128i*)(c + i));
+        sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i))));
+        if (OUTPUTS > 1U)
+            sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 1U))));
+        if (OUTPUTS > 2U)
+            sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 2U))));
+        if (OUTPUTS > 3U)
+            sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(vc, _mm_loadu_si128((const __m128i*)(x + i + 3U))));
+        i += 8U;
+    }
+
+    // lane j of the result is the sum of accumulator j
+    __m128i sum = _mm_hadd_epi32(_mm_hadd_epi32(sum0, sum1), _mm_hadd_epi32(sum2, sum3));
+    uint32_t sums[4U];
+    _mm_storeu_si128((__m128i*)sums, sum);
+
+    for (uint32_t j = 0U; j < OUTPUTS; j++) {
+        for (uint32_t k = i; k < n; k++)
+            sums[j] += (uint32_t)((q31_t)x[k + j] * c[k]);
+        result[j] = sums[j];
+    }
+}
+#endif // defined(ARM_MATH_X86_SIMD)
+
+#if defined(ARM_MATH_NEON_SIMD)
+/* NEON Q15 dot product, 32-bit accumulation. */
+
+static uint32_t firDotNEON(const q15_t* x, const q15_t* c, uint32_t n)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+
+    uint32_t i = 0U;
+    for (; i + 8U <= n; i += 8U) {
+        int16x8_t vx = vld1q_s16(x + i);
+        int16x8_t vc = vld1q_s16(c + i);
+        acc = vmlal_s16(acc, vget_low_s16(vx), vget_low_s16(vc));
+        acc = vmlal_s16(acc, vget_high_s16(vx), vget_high_s16(vc));
+    }
+
+    int32x2_t acc2 = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    acc2 = vpadd_s32(acc2, acc2);
+    uint32_t sum = (uint32_t)vget_lane_s32(acc2, 0);
+
+    for (; i < n; i++)
+        sum += (uint32_t)((q31_t)x[i] * c[i]);
+
+    return sum;
+}
+
+/* NEON Q15 dot products of a coefficient vector with OUTPUTS consecutive windows of the input, 32-bit accumulation. */
+
+template <uint32_t OUTPUTS>
+static void firDotBlockNEON(const q15_t* x, const q15_t* c, uint32_t n, uint32_t* result)
+{
+    int32x4_t acc[4U] = { vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0) };
+
+    // each chunk of coefficients is loaded once for all of the outputs
+    uint32_t i = 0U;
+    for (; i + 8U <= n; i += 8U) {
+        int16x8_t vc = vld1q_s16(c + i);
+        for (uint32_t j = 0U; j < OUTPUTS; j++) {
+            int16x8_t vx = vld1q_s16(x + i + j);
+            acc[j] = vmlal_s16(acc[j], vget_low_s16(vx), vget_low_s16(vc));
+            acc[j] = vmlal_s16(acc[j], vget_high_s16(vx), vget_high_s16(vc));
+        }
+    }
+
+    for (uint32_t j = 0U; j < OUTPUTS; j++) {
+        int32x2_t acc2 = vadd_s32(vget_low_s32(acc[j]), vget_high_s32(acc[j]));
+        acc2 = vpadd_s32(acc2, acc2);
+        uint32_t sum = (uint32_t)vget_lane_s32(acc2, 0);
+
+        for (uint32_t k = i; k < n; k++)
+            sum += (uint32_t)((q31_t)x[k + j] * c[k]);
+        result[j] = sum;
+    }
+}
+#endif // defined(ARM_MATH_NEON_SIMD)
+
+// ---------------------------------------------------------------------------
+//  Kernel Dispatch
+// ---------------------------------------------------------------------------
+
+typedef uint32_t (*FirDotFn)(const q15_t* x, const q15_t* c, uint32_t n);
+typedef void (*FirDotBlockFn)(const q15_t* x, const q15_t* c, uint32_t n, uint32_t* result);
+
+/**
+ * @brief Host SIMD kernels selected at startup.
+ */
+struct ArmMathKernels {
+    const char* name;
+    FirDotFn firDot;
+    FirDotBlockFn firDotBlock[FIR_BLOCK_OUTPUTS_MAX];      // by number of outputs - 1
+};
+
+/* Helper to select the SIMD kernels supported by the host CPU. */
+
+static ArmMathKernels selectKernels()
+{
+    ArmMathKernels kernels = { "scalar", nullptr, { nullptr, nullptr, nullptr, nullptr } };
+
+#if defined(ARM_MATH_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) {
+        kernels.name = "SSE4.1";
+        kernels.firDot = firDotSSE41;
+        kernels.firDotBlock[0U] = firDotBlockSSE41<1U>;
+        kernels.firDotBlock[1U] = firDotBlockSSE41<2U>;
+        kernels.firDotBlock[2U] = firDotBlockSSE41<3U>;
+        kernels.firDotBlock[3U] = firDotBlockSSE41<4U>;
+
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.name = "AVX2";
+            kernels.firDot = firDotAVX2;
+            kernels.firDotBlock[0U] = firDotBlockAVX2<1U>;
+            kernels.firDotBlock[1U] = firDotBlockAVX2<2U>;
+            kernels.firDotBlock[2U] = firDotBlockAVX2<3U>;
+            kernels.firDotBlock[3U] = firDotBlockAVX2<4U>;
+        }
+    }
+#endif // defined(ARM_MATH_X86_SIMD)
+#if defined(ARM_MATH_NEON_SIMD)
+    bool neon = true;
+#if defined(__linux__)
+#if defined(__aarch64__)
+    neon = (::getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0U;
+#else
+    neon = (::getauxval(AT_HWCAP) & HWCAP_NEON) != 0U;
+#endif // defined(__aarch64__)
+#endif // defined(__linux__)
+    if (neon) {
+        kernels.name = "NEON";
+        kernels.firDot = firDotNEON;
+        kernels.firDotBlock[0U] = firDotBlockNEON<1U>;
+        kernels.firDotBlock[1U] = firDotBlockNEON<2U>;
+        kernels.firDotBlock[2U] = firDotBlockNEON<3U>;
+        kernels.firDotBlock[3U] = firDotBlockNEON<4U>;
+    }
+#endif // defined(ARM_MATH_NEON_SIMD)
+
+    return kernels;
+}
+
+// any filter called before static initialization completes simply takes the scalar path
+static ArmMathKernels s_kernels = selectKernels();
+
+/* Gets the name of the SIMD kernels selected for the host CPU. */
+
+const char* arm_math_simd_name()
+{
+    return (s_kernels.name != nullptr) ? s_kernels.name : "scalar";
+}
+
+/* Computes the fast (32-bit accumulating) dot product of two Q15 vectors. */
+
+q31_t arm_dot_prod_fast_q15(const q15_t* pSrcA, const q15_t* pSrcB, uint32_t blockSize)
+{
+    if (s_kernels.firDot != nullptr && blockSize >= FIR_SIMD_MIN_TAPS)
+        return (q31_t)s_kernels.firDot(pSrcA, pSrcB, blockSize);
+
+    uint32_t sum = 0U;
+    for (uint32_t i = 0U; i < blockSize; i++)
+        sum += (uint32_t)((q31_t)pSrcA[i] * pSrcB[i]);
+
+    return (q31_t)sum;
+}
+
+/* Computes a block of consecutive outputs of several fast Q15 FIR filters sharing one sample history. */
+
+void arm_fir_bank_fast_q15(const q15_t* pSrc, uint32_t windowSize, const q15_t* const* pCoeffs, const uint32_t* pOffsets,
+    uint32_t numFilters, uint32_t numOutputs, q31_t* pResult)
+{
+    for (uint32_t i = 0U; i < numFilters; i++) {
+        const q15_t* x = pSrc + pOffsets[i];
+        const q15_t* c = pCoeffs[i];
+        uint32_t taps = windowSize - pOffsets[i];
+        uint32_t* result = (uint32_t*)(pResult + i * numOutputs);
+
+        FirDotBlockFn kernel = (numOutputs >= 1U && numOutputs <= FIR_BLOCK_OUTPUTS_MAX) ? s_kernels.firDotBlock[numOutputs - 1U] : nullptr;
+        if (kernel != nullptr && taps >= FIR_SIMD_MIN_TAPS) {
+            kernel(x, c, taps, result);
+            continue;
+        }
+
+        for (uint32_t j = 0U; j < numOutputs; j++)
+            result[j] = (uint32_t)::arm_dot_prod_fast_q15(x + j, c, taps);
+    }
+}
+
+/* Processing function for the fast Q15 FIR filter for Cortex-M3 and Cortex-M4. */
+
+void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    // the scalar routine only defines the result for an even number of taps
+    uint16_t numTaps = S->numTaps;
+    if (s_kernels.firDot == nullptr || numTaps < FIR_SIMD_MIN_TAPS || (numTaps & 1U) != 0U) {
+        firFastScalar(S, pSrc, pDst, blockSize);
+        return;
+    }
+
+    /* S->pState buffer contains previous frame (numTaps - 1) samples */
+    ::memcpy(S->pState + (numTaps - 1U), pSrc, blockSize * sizeof(q15_t));
+
+    for (uint32_t n = 0U; n < blockSize; n++) {
+        q31_t acc = (q31_t)s_kernels.firDot(S->pState + n, S->pCoeffs, numTaps);
+        pDst[n] = (q15_t)(__SSAT((acc >> 15), 16));
+    }
+
+    /* Copy the last numTaps - 1 samples to the start of the state buffer */
+    ::memmove(S->pState, S->pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
 /* Processing function for the Q31 Biquad cascade filter */
 
 void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31* S, q31_t* pSrc, q31_t* pDst, uint32_t blockSize)
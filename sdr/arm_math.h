@@ -112,6 +112,12 @@ typedef struct {
 //  Global Functions
 // ---------------------------------------------------------------------------
 
+/**
+ * @brief Gets the name of the SIMD kernels selected (at startup) for the host CPU.
+ * @returns const char* Name of the kernels ("AVX2", "SSE4.1", "NEON" or "scalar").
+ */
+const char* arm_math_simd_name();
+
 /**
  * @brief Processing function for the Q15 FIR interpolator.
  * @param S An instance of the Q15 FIR interpolator structure.
@@ -130,6 +136,32 @@ void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* p
  */
 void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize);
 
+/**
+ * @brief Computes the fast dot product of two Q15 vectors. The products are accumulated in 32-bits
+ *  (wrapping), exactly as arm_fir_fast_q15() accumulates each output.
+ * @param pSrcA First input vector.
+ * @param pSrcB Second input vector.
+ * @param blockSize Number of samples in each vector.
+ * @returns q31_t Dot product (2.30 format).
+ */
+q31_t arm_dot_prod_fast_q15(const q15_t* pSrcA, const q15_t* pSrcB, uint32_t blockSize);
+
+/**
+ * @brief Computes a block of consecutive outputs of several fast Q15 FIR filters sharing one sample
+ *  history. Output j of filter i is the dot product of pCoeffs[i] with the history window starting at
+ *  pSrc + j + pOffsets[i]; i.e. a filter shorter than the window covers only its newest samples. Each
+ *  product is accumulated in 32-bits (wrapping), exactly as arm_fir_fast_q15() accumulates each output.
+ * @param pSrc Sample history, windowSize + numOutputs - 1 samples long.
+ * @param windowSize Number of samples in each window.
+ * @param pCoeffs Filter coefficients (pCoeffs[i] is windowSize - pOffsets[i] samples long).
+ * @param pOffsets Offset into each window, at which each filter starts.
+ * @param numFilters Number of filters.
+ * @param numOutputs Number of consecutive outputs to compute.
+ * @param pResult Outputs (2.30 format), numOutputs for each filter in turn.
+ */
+void arm_fir_bank_fast_q15(const q15_t* pSrc, uint32_t windowSize, const q15_t* const* pCoeffs, const uint32_t* pOffsets,
+    uint32_t numFilters, uint32_t numOutputs, q31_t* pResult);
+
 /**
  * @brief Processing function for the Q31 Biquad cascade filter
  * @param S An instance of the Q15 FIR interpolator structure.
@@ -0,0 +1,449 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file DSPBench.cpp
+ * @ingroup modem_fw
+ *
+ * Host benchmark of the Rx DSP routines of the SDR build. Each result is the best of several runs over
+ * the same synthetic samples, e.g.:
+ *
+ *  dvm-dsp-bench -b        Rx front end cost per sample, at each Rx block size
+ *  dvm-dsp-bench -c        P25 sync correlation, per symbol wrapping vs. correlateSymbols()
+ *  dvm-dsp-bench -f        Rx FIR filters, arm_fir_fast_q15() vs. FIRFilter, at several block sizes
+ *
+ * These are host (x86/ARM Linux) numbers only; they are not cycle counts for the Cortex-M targets.
+ */
+#include "Defines.h"
+#include "FIRFilter.h"
+#include "Utils.h"
+#include "p25/P25Defines.h"
+
+using namespace p25;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+#define IS(s) (::strcmp(argv[i], s) == 0)
+
+const uint32_t SAMPLE_RATE = 24000U;
+const uint32_t BENCH_SAMPLES = 2400000U;    // 100 s of samples per run
+const uint8_t BENCH_RUNS_DEFAULT = 5U;
+
+const uint16_t BLOCK_SIZES[] = { 2U, 4U, 8U, 16U, 32U, 64U, 96U, 120U, 240U, 480U };
+const uint8_t BLOCK_SIZES_COUNT = sizeof(BLOCK_SIZES) / sizeof(uint16_t);
+
+// filter lengths of the IO front end (the coefficient values do not change the cost)
+const uint16_t RRC_0_2_FILTER_LEN = 42U;
+const uint16_t BOXCAR_5_FILTER_LEN = 6U;
+const uint16_t NXDN_0_2_FILTER_LEN = 82U;
+const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
+const uint16_t COEFFS_MAX = 82U;
+
+// Generated using [b, a] = butter(1, 0.001) in MATLAB
+static q31_t DC_FILTER[] = { 3367972, 0, 3367972, 0, 2140747704, 0 }; // {b0, 0, b1, b2, -a1, -a2}
+const uint16_t DC_LEVEL_AVERAGE = 2U;
+const uint16_t DC_OFFSET = 2048U;
+
+const uint32_t FIR_SAMPLES = 480000U;       // 20 s of samples per run
+const uint16_t FIR_TAPS[] = { RRC_0_2_FILTER_LEN, NXDN_0_2_FILTER_LEN };
+const uint16_t FIR_BLOCK_SIZES[] = { 2U, 32U, 480U };
+
+const uint16_t CORR_PASSES = 500U;          // passes over every start position of the P25 frame buffer
+
+// ---------------------------------------------------------------------------
+//  Global Variables
+// ---------------------------------------------------------------------------
+
+static q15_t g_coeffs[COEFFS_MAX];
+static uint16_t g_adc[BENCH_SAMPLES];
+
+static q15_t g_firIn[FIR_SAMPLES];
+static q15_t g_firOut[2U][FIR_SAMPLES];
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/* Helper to print usage and exit. */
+
+static void usage(const char* exe)
+{
+    ::fprintf(stderr,
+        "usage: %s [-b] [-c] [-f] [-n <runs>]\n\n"
+        "  -b       Rx front end cost per sample, at each Rx block size\n"
+        "  -c       P25 sync correlation, per symbol wrapping vs. correlateSymbols()\n"
+        "  -f       Rx FIR filters, arm_fir_fast_q15() vs. FIRFilter, at several block sizes\n"
+        "  -n       number of runs each result is the best of (default %u)\n\n"
+        "With no benchmark selected, every benchmark is run.\n",
+        exe, BENCH_RUNS_DEFAULT);
+    ::exit(EXIT_FAILURE);
+}
+
+/* Helper to get the monotonic clock in nanoseconds. */
+
+static uint64_t now()
+{
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+}
+
+/* Helper to fill the coefficients and the (12-bit ADC) input samples with repeatable values. */
+
+static void fillSamples()
+{
+    uint32_t seed = 0x2545F491U;
+    for (uint16_t i = 0U; i < COEFFS_MAX; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        g_coeffs[i] = q15_t(int32_t(seed >> 17) - 16384);
+    }
+
+    for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        g_adc[i] = uint16_t(seed >> 20);
+    }
+}
+
+// ---------------------------------------------------------------------------
+//  Rx Front End
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Rx front end of the IO class, in idle with DMR, P25 and NXDN enabled and the DC blocker on.
+ */
+struct RxFrontEnd {
+    FIRFilterBank rxBank;
+    FIRFilterBank dcBank;
+    FIRFilter isinc;
+    q15_t isincState[2U * NXDN_ISINC_FILTER_LEN];
+
+    arm_biquad_casd_df1_inst_q31 dcFilter;
+    q31_t dcState[4U];
+
+    RxFrontEnd() :
+        rxBank(),
+        dcBank(),
+        isinc(),
+        isincState(),
+        dcFilter(),
+        dcState()
+    {
+        rxBank.addFilter(g_coeffs, RRC_0_2_FILTER_LEN);
+        rxBank.addFilter(g_coeffs, BOXCAR_5_FILTER_LEN);
+        rxBank.addFilter(g_coeffs, NXDN_0_2_FILTER_LEN);
+        dcBank.addFilter(g_coeffs, BOXCAR_5_FILTER_LEN);
+        dcBank.addFilter(g_coeffs, NXDN_0_2_FILTER_LEN);
+
+        isinc.init(g_coeffs, NXDN_ISINC_FILTER_LEN, isincState);
+
+        dcFilter.numStages = 1U;
+        dcFilter.pState = dcState;
+        dcFilter.pCoeffs = DC_FILTER;
+        dcFilter.postShift = 0;
+    }
+
+    /**
+     * @brief Processes a block of ADC samples, as IO::process() does.
+     * @param adc ADC samples.
+     * @param blockSize Number of samples.
+     */
+    void process(const uint16_t* adc, uint16_t blockSize)
+    {
+        q15_t samples[RX_BLOCK_SIZE_MAX];
+        for (uint16_t i = 0U; i < blockSize; i++) {
+            q15_t res1 = q15_t(adc[i]) - q15_t(DC_OFFSET);
+            q31_t res2 = res1 * (128 * 128);
+            samples[i] = q15_t(__SSAT((res2 >> 15), 16));
+        }
+
+        q31_t q31Samples[RX_BLOCK_SIZE_MAX];
+        ::arm_q15_to_q31(samples, q31Samples, blockSize);
+
+        q31_t dcValues[RX_BLOCK_SIZE_MAX];
+        ::arm_biquad_cascade_df1_q31(&dcFilter, q31Samples, dcValues, blockSize);
+
+        q15_t dcSamples[RX_BLOCK_SIZE_MAX];
+        for (uint16_t i = 0U; i < blockSize; i += DC_LEVEL_AVERAGE) {
+            q31_t dcLevel = 0;
+            for (uint16_t j = 0U; j < DC_LEVEL_AVERAGE; j++)
+                dcLevel += dcValues[i + j];
+            dcLevel /= DC_LEVEL_AVERAGE;
+
+            q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));
+            for (uint16_t j = 0U; j < DC_LEVEL_AVERAGE; j++)
+                dcSamples[i + j] = samples[i + j] - offset;
+        }
+
+        q15_t dmrSamples[RX_BLOCK_SIZE_MAX];
+        q15_t p25Samples[RX_BLOCK_SIZE_MAX];
+        q15_t nxdnSamples[RX_BLOCK_SIZE_MAX];
+
+        q15_t* rxOutputs[FIR_BANK_FILTERS_MAX] = { dmrSamples, NULL, NULL };
+        q15_t* dcOutputs[FIR_BANK_FILTERS_MAX] = { p25Samples, nxdnSamples, NULL };
+        rxBank.process(samples, rxOutputs, blockSize);
+        dcBank.process(dcSamples, dcOutputs, blockSize);
+
+        isinc.process(nxdnSamples, nxdnSamples, blockSize);
+    }
+};
+
+/* Helper to benchmark the Rx front end at each Rx block size. */
+
+static void benchBlocks(uint8_t runs)
+{
+    ::fprintf(stdout, "Rx front end (DMR, P25 and NXDN filters, DC blocker), best of %u runs\n", runs);
+    ::fprintf(stdout, "  block   ns/sample   load at %u samples/s\n", SAMPLE_RATE);
+
+    for (uint8_t n = 0U; n < BLOCK_SIZES_COUNT; n++) {
+        uint16_t blockSize = BLOCK_SIZES[n];
+        if (blockSize > RX_BLOCK_SIZE_MAX)
+            continue;
+
+        uint32_t length = BENCH_SAMPLES - (BENCH_SAMPLES % blockSize);
+        uint64_t best = 0U;
+        for (uint8_t r = 0U; r < runs; r++) {
+            RxFrontEnd* frontEnd = new RxFrontEnd();
+
+            uint64_t start = now();
+            for (uint32_t i = 0U; i < length; i += blockSize)
+                frontEnd->process(g_adc + i, blockSize);
+            uint64_t time = now() - start;
+
+            delete frontEnd;
+            if (r == 0U || time < best)
+                best = time;
+        }
+
+        double nsPerSample = double(best) / length;
+        ::fprintf(stdout, "  %5u   %9.1f   %5.2f%%\n", blockSize, nsPerSample, nsPerSample * SAMPLE_RATE / 1e7);
+    }
+}
+
+// ---------------------------------------------------------------------------
+//  FIR Filters
+// ---------------------------------------------------------------------------
+
+/* Helper to filter the FIR input samples with arm_fir_fast_q15(), returning the time taken. */
+
+static uint64_t firFast(uint16_t numTaps, uint16_t blockSize, uint32_t length, q15_t* out)
+{
+    q15_t state[FIR_BANK_TAPS_MAX + RX_BLOCK_SIZE_MAX];
+    ::memset(state, 0x00U, sizeof(state));
+
+    arm_fir_instance_q15 filter;
+    filter.numTaps = numTaps;
+    filter.pState = state;
+    filter.pCoeffs = g_coeffs;
+
+    uint64_t start = now();
+    for (uint32_t i = 0U; i < length; i += blockSize)
+        ::arm_fir_fast_q15(&filter, g_firIn + i, out + i, blockSize);
+    return now() - start;
+}
+
+/* Helper to filter the FIR input samples with FIRFilter, returning the time taken. */
+
+static uint64_t firFilter(uint16_t numTaps, uint16_t blockSize, uint32_t length, q15_t* out)
+{
+    q15_t state[2U * FIR_BANK_TAPS_MAX];
+
+    FIRFilter filter;
+    filter.init(g_coeffs, numTaps, state);
+
+    uint64_t start = now();
+    for (uint32_t i = 0U; i < length; i += blockSize)
+        filter.process(g_firIn + i, out + i, blockSize);
+    return now() - start;
+}
+
+/* Helper to benchmark the Rx FIR filters at each filter length and block size. */
+
+static bool benchFilters(uint8_t runs)
+{
+    for (uint32_t i = 0U; i < FIR_SAMPLES; i++)
+        g_firIn[i] = q15_t((int16_t(g_adc[i]) - int16_t(DC_OFFSET)) * 8);
+
+    ::fprintf(stdout, "Rx FIR filters, best of %u runs\n", runs);
+    ::fprintf(stdout, "   taps   block   arm_fir_fast_q15   FIRFilter   (ns/sample)\n");
+
+    for (uint8_t t = 0U; t < sizeof(FIR_TAPS) / sizeof(uint16_t); t++) {
+        for (uint8_t b = 0U; b < sizeof(FIR_BLOCK_SIZES) / sizeof(uint16_t); b++) {
+            uint16_t numTaps = FIR_TAPS[t];
+            uint16_t blockSize = FIR_BLOCK_SIZES[b];
+            uint32_t length = FIR_SAMPLES - (FIR_SAMPLES % blockSize);
+
+            uint64_t best[2U] = { 0U, 0U };
+            for (uint8_t r = 0U; r < runs; r++) {
+                uint64_t time[2U];
+                time[0U] = firFast(numTaps, blockSize, length, g_firOut[0U]);
+                time[1U] = firFilter(numTaps, blockSize, length, g_firOut[1U]);
+
+                for (uint8_t n = 0U; n < 2U; n++) {
+                    if (r == 0U || time[n] < best[n])
+                        best[n] = time[n];
+                }
+            }
+
+            // FIRFilter accumulates exactly as arm_fir_fast_q15() does, the outputs must be identical
+            if (::memcmp(g_firOut[0U], g_firOut[1U], length * sizeof(q15_t)) != 0) {
+                ::fprintf(stderr, "FIR output mismatch, %u taps, block size %u\n", numTaps, blockSize);
+                return false;
+            }
+
+            ::fprintf(stdout, "  %5u   %5u   %16.1f   %9.1f\n", numTaps, blockSize,
+                double(best[0U]) / length, double(best[1U]) / length);
+        }
+    }
+
+    ::fprintf(stdout, "  outputs identical\n");
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+//  Sync Correlation
+// ---------------------------------------------------------------------------
+
+/* Helper to correlate the P25 sync symbols, as P25RX::correlateSync() did before correlateSymbols(). */
+
+static q31_t correlateSyncWrapping(const q15_t* buffer, uint16_t ptr, q15_t& min, q15_t& max)
+{
+    q31_t corr = 0;
+    min = 16000;
+    max = -16000;
+
+    for (uint8_t i = 0U; i < P25_SYNC_LENGTH_SYMBOLS; i++) {
+        q15_t val = buffer[ptr];
+
+        if (val > max)
+            max = val;
+        if (val < min)
+            min = val;
+
+        switch (P25_SYNC_SYMBOLS_VALUES[i]) {
+        case +3:
+            corr -= (val + val + val);
+            break;
+        case +1:
+            corr -= val;
+            break;
+        case -1:
+            corr += val;
+            break;
+        default:  // -3
+            corr += (val + val + val);
+            break;
+        }
+
+        ptr += P25_RADIO_SYMBOL_LENGTH;
+        if (ptr >= P25_LDU_FRAME_LENGTH_SAMPLES)
+            ptr -= P25_LDU_FRAME_LENGTH_SAMPLES;
+    }
+
+    return corr;
+}
+
+/* Helper to benchmark the P25 sync correlation over every start position of the frame buffer. */
+
+static bool benchCorrelate(uint8_t runs)
+{
+    q15_t buffer[P25_LDU_FRAME_LENGTH_SAMPLES];
+    for (uint16_t i = 0U; i < P25_LDU_FRAME_LENGTH_SAMPLES; i++)
+        buffer[i] = q15_t((int16_t(g_adc[i]) - int16_t(DC_OFFSET)) * 8);
+
+    // both correlations must agree at every start position, including those where the sync wraps
+    for (uint16_t ptr = 0U; ptr < P25_LDU_FRAME_LENGTH_SAMPLES; ptr++) {
+        q15_t min1, max1, min2, max2;
+        q31_t corr1 = correlateSyncWrapping(buffer, ptr, min1, max1);
+        q31_t corr2 = correlateSymbols(buffer, P25_LDU_FRAME_LENGTH_SAMPLES, ptr, P25_SYNC_SYMBOLS_VALUES, P25_SYNC_LENGTH_SYMBOLS,
+            P25_RADIO_SYMBOL_LENGTH, min2, max2);
+        if (corr1 != corr2 || min1 != min2 || max1 != max2) {
+            ::fprintf(stderr, "P25 sync correlation mismatch at %u, corr %d/%d min %d/%d max %d/%d\n", ptr, corr1, corr2, min1, min2, max1, max2);
+            return false;
+        }
+    }
+
+    uint64_t best[2U] = { 0U, 0U };
+    q31_t check = 0;
+    for (uint8_t r = 0U; r < runs; r++) {
+        for (uint8_t n = 0U; n < 2U; n++) {
+            uint64_t start = now();
+            for (uint16_t pass = 0U; pass < CORR_PASSES; pass++) {
+                for (uint16_t ptr = 0U; ptr < P25_LDU_FRAME_LENGTH_SAMPLES; ptr++) {
+                    q15_t min, max;
+                    if (n == 0U)
+                        check += correlateSyncWrapping(buffer, ptr, min, max) + min + max;
+                    else
+                        check += correlateSymbols(buffer, P25_LDU_FRAME_LENGTH_SAMPLES, ptr, P25_SYNC_SYMBOLS_VALUES, P25_SYNC_LENGTH_SYMBOLS,
+                            P25_RADIO_SYMBOL_LENGTH, min, max) + min + max;
+                }
+            }
+            uint64_t time = now() - start;
+
+            if (r == 0U || time < best[n])
+                best[n] = time;
+        }
+    }
+
+    double calls = double(CORR_PASSES) * P25_LDU_FRAME_LENGTH_SAMPLES;
+    ::fprintf(stdout, "P25 sync correlation (%u symbols, every start position), best of %u runs\n", P25_SYNC_LENGTH_SYMBOLS, runs);
+    ::fprintf(stdout, "  per symbol wrapping   %6.1f ns/call\n", double(best[0U]) / calls);
+    ::fprintf(stdout, "  correlateSymbols()    %6.1f ns/call\n", double(best[1U]) / calls);
+    ::fprintf(stdout, "  results identical (check %d)\n", check);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+//  Program Entry Point
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    bool blocks = false;
+    bool correlate = false;
+    bool filters = false;
+    int runs = BENCH_RUNS_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        if (IS("-b"))
+            blocks = true;
+        else if (IS("-c"))
+            correlate = true;
+        else if (IS("-f"))
+            filters = true;
+        else if (IS("-n") && (i + 1) < argc)
+            runs = ::atoi(argv[++i]);
+        else
+            usage(argv[0]);
+    }
+
+    if (runs < 1 || runs > 100)
+        usage(argv[0]);
+
+    // with no benchmark selected, run them all
+    if (!blocks && !correlate && !filters)
+        blocks = correlate = filters = true;
+
+    fillSamples();
+
+    if (blocks)
+        benchBlocks(uint8_t(runs));
+    if (correlate && !benchCorrelate(uint8_t(runs)))
+        return EXIT_FAILURE;
+    if (filters && !benchFilters(uint8_t(runs)))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Digital Voice Modem - Modem Firmware
+ * GPLv2 Open Source. Use is subject to license terms.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ *  Copyright (C) 2026 Bryan Biedenkapp, N2PLL
+ *
+ */
+/**
+ * @file ShmPipe.cpp
+ * @ingroup modem_fw
+ *
+ * Reference producer/consumer for the shared memory baseband transport. This bridges the firmware
+ * shm:// rings to raw 16-bit host byte order sample streams on stdin/stdout, e.g.:
+ *
+ *  dvm-firmware_sdr -r shm://dvm-rx -t shm://dvm-tx
+ *  dvm-shm-pipe -t shm://dvm-tx | dvm-shm-pipe -s -r shm://dvm-rx
+ */
+#include "sdr/ShmRing.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <string>
+#include <unistd.h>
+#include <time.h>
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+#define IS(s) (::strcmp(argv[i], s) == 0)
+
+const uint32_t SAMPLE_RATE = 24000U;
+const uint32_t BLOCK_SAMPLES = 720U;
+const uint32_t WAIT_TIMEOUT = 100U;     // ms
+
+// ---------------------------------------------------------------------------
+//  Global Variables
+// ---------------------------------------------------------------------------
+
+static volatile sig_atomic_t g_killed = 0;
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/* Internal signal handler. */
+
+static void sigHandler(int signum)
+{
+    g_killed = 1;
+}
+
+/* Helper to print usage and exit. */
+
+static void usage(const char* exe)
+{
+    ::fprintf(stderr,
+        "usage: %s [-s] -r <shm://name> | -t <shm://name>\n\n"
+        "  -r       write samples read from stdin into the firmware Rx ring\n"
+        "  -t       write samples read from the firmware Tx ring to stdout\n"
+        "  -s       pace stdin at the 24000 samples/s sample rate (-r only)\n",
+        exe);
+    ::exit(EXIT_FAILURE);
+}
+
+/* Helper to attach to a ring segment created by the firmware, waiting for it to appear. */
+
+static bool attach(ShmRing& ring, const std::string& endpoint)
+{
+    bool warned = false;
+    while (!g_killed) {
+        if (ring.open(endpoint, false))
+            return true;
+
+        if (!warned) {
+            ::fprintf(stderr, "waiting for %s ...\n", endpoint.c_str());
+            warned = true;
+        }
+
+        ::usleep(100000U);
+    }
+
+    return false;
+}
+
+/* Helper to copy stdin into the firmware Rx ring. */
+
+static int produce(ShmRing& ring, bool pace)
+{
+    int16_t block[BLOCK_SAMPLES];
+    size_t offset = 0U; // bytes of a partial sample carried over from the last read
+
+    struct timespec deadline;
+    ::clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (!g_killed) {
+        // forward whatever is available, rather than waiting for a full block
+        ssize_t ret = ::read(STDIN_FILENO, (uint8_t*)block + offset, sizeof(block) - offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            break;
+
+        size_t bytes = offset + size_t(ret);
+        uint32_t length = uint32_t(bytes / sizeof(int16_t));
+        offset = bytes % sizeof(int16_t);
+        if (length == 0U)
+            continue;
+
+        if (pace) {
+            deadline.tv_nsec += long((uint64_t(length) * 1000000000ULL) / SAMPLE_RATE);
+            while (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_nsec -= 1000000000L;
+                deadline.tv_sec++;
+            }
+
+            while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR && !g_killed) { /* stub */ }
+        }
+
+        while (!g_killed && !ring.waitForSpace(length, WAIT_TIMEOUT)) { /* stub */ }
+        ring.write(block, length);
+
+        if (offset > 0U)
+            ::memmove(block, (uint8_t*)block + (bytes - offset), offset);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* Helper to copy the firmware Tx ring to stdout. */
+
+static int consume(ShmRing& ring)
+{
+    int16_t block[BLOCK_SAMPLES];
+
+    while (!g_killed) {
+        if (ring.waitForData(WAIT_TIMEOUT) == 0U)
+            continue;
+
+        uint32_t length = ring.read(block, BLOCK_SAMPLES);
+        if (::fwrite(block, sizeof(int16_t), length, stdout) != length)
+            return EXIT_FAILURE;
+        ::fflush(stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+//  Program Entry Point
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    std::string rx, tx;
+    bool pace = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (IS("-r") && (i + 1) < argc)
+            rx = std::string(argv[++i]);
+        else if (IS("-t") && (i + 1) < argc)
+            tx = std::string(argv[++i]);
+        else if (IS("-s"))
+            pace = true;
+        else
+            usage(argv[0]);
+    }
+
+    if (rx.empty() == tx.empty())
+        usage(argv[0]);
+
+    ::signal(SIGINT, sigHandler);
+    ::signal(SIGTERM, sigHandler);
+    ::signal(SIGPIPE, sigHandler);
+
+    ShmRing ring;
+    if (!rx.empty()) {
+        if (!ShmRing::isShmEndpoint(rx) || !attach(ring, rx))
+            usage(argv[0]);
+        return produce(ring, pace);
+    }
+
+    if (!ShmRing::isShmEndpoint(tx) || !attach(ring, tx))
+        usage(argv[0]);
+    return consume(ring);
+}